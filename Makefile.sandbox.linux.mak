@@ -8,6 +8,11 @@ INCLUDE_FLAGS := -Iengine/src -I$(VULKAN_SDK)\include
 LINKER_FLAGS := -L./$(BUILD_DIR)/ -lengine -Wl,-rpath,.
 DEFINES := -D_DEBUG -DPE_IMPORT
 
+# make HEADLESS=1 builds without a window, rendering offscreen
+ifeq ($(HEADLESS),1)
+DEFINES += -DPE_HEADLESS=1
+endif
+
 # Make does not offer a recursive wildcard function, so here's one:
 #rwildcard=$(wildcard $1$2) $(foreach d,$(wildcard $1*),$(call rwildcard,$d/,$2))
 
@@ -0,0 +1,222 @@
+#include "containers/bitset.h"
+
+#include "core/pe_memory.h"
+#include "core/logger.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BITSET_SSE2 1
+#endif
+
+// Blocks are loaded with aligned 256 bit loads
+#define WORDS_ALIGNMENT 32
+
+static u64 word_count_for(u64 bit_count) {
+    u64 words = (bit_count + 63) / 64;
+    return pe_align_up(words ? words : 1, BITSET_BLOCK_WORDS);
+}
+
+// Clears the bits past bit_count in the last used word, keeping the tail invariant
+static void clear_tail(bitset* set) {
+    u64 used_bits = set->bit_count & 63;
+    if (used_bits) {
+        set->words[set->bit_count >> 6] &= ((u64)1 << used_bits) - 1;
+    }
+}
+
+b8 bitset_create(u64 bit_count, bitset* out_bitset) {
+    if (!out_bitset) {
+        PE_ERROR("bitset_create - requires a pointer to hold the bitset.");
+        return false;
+    }
+
+    out_bitset->bit_count = bit_count;
+    out_bitset->word_count = word_count_for(bit_count);
+    // Zeroed, which clears every bit
+    out_bitset->words = pe_allocate_aligned(out_bitset->word_count * sizeof(u64), WORDS_ALIGNMENT, MEMORY_TAG_ARRAY);
+    return out_bitset->words != 0;
+}
+
+void bitset_destroy(bitset* set) {
+    if (set && set->words) {
+        pe_free_aligned(set->words, set->word_count * sizeof(u64), WORDS_ALIGNMENT, MEMORY_TAG_ARRAY);
+        pe_zero_memory(set, sizeof(bitset));
+    }
+}
+
+b8 bitset_resize(bitset* set, u64 bit_count) {
+    u64 word_count = word_count_for(bit_count);
+    if (word_count != set->word_count) {
+        u64* words = pe_allocate_aligned(word_count * sizeof(u64), WORDS_ALIGNMENT, MEMORY_TAG_ARRAY);
+        if (!words) {
+            return false;
+        }
+        u64 kept = word_count < set->word_count ? word_count : set->word_count;
+        pe_copy_memory(words, set->words, kept * sizeof(u64));
+        pe_free_aligned(set->words, set->word_count * sizeof(u64), WORDS_ALIGNMENT, MEMORY_TAG_ARRAY);
+        set->words = words;
+        set->word_count = word_count;
+    }
+
+    if (bit_count < set->bit_count) {
+        // Clear what was cut off within the kept words
+        set->bit_count = bit_count;
+        clear_tail(set);
+        u64 first_unused = (bit_count + 63) / 64;
+        pe_zero_memory(set->words + first_unused, (set->word_count - first_unused) * sizeof(u64));
+    }
+    set->bit_count = bit_count;
+    return true;
+}
+
+void bitset_set_all(bitset* set) {
+    u64 full_words = set->bit_count >> 6;
+    pe_set_memory(set->words, 0xFF, full_words * sizeof(u64));
+    if (set->bit_count & 63) {
+        set->words[full_words] = ((u64)1 << (set->bit_count & 63)) - 1;
+    }
+}
+
+void bitset_clear_all(bitset* set) {
+    pe_zero_memory(set->words, set->word_count * sizeof(u64));
+}
+
+u64 bitset_count(const bitset* set) {
+#if defined(__AVX2__)
+    // Per nibble lookup, summed into 64 bit lanes with sad (Mula's method)
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+    for (u64 i = 0; i < set->word_count; i += BITSET_BLOCK_WORDS) {
+        __m256i block = _mm256_load_si256((const __m256i*)(set->words + i));
+        __m256i low = _mm256_and_si256(block, low_mask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_mask);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    return (u64)_mm256_extract_epi64(total, 0) + (u64)_mm256_extract_epi64(total, 1) +
+           (u64)_mm256_extract_epi64(total, 2) + (u64)_mm256_extract_epi64(total, 3);
+#else
+    u64 count = 0;
+    for (u64 i = 0; i < set->word_count; ++i) {
+        count += (u64)__builtin_popcountll(set->words[i]);
+    }
+    return count;
+#endif
+}
+
+b8 bitset_any(const bitset* set) {
+    for (u64 i = 0; i < set->word_count; i += BITSET_BLOCK_WORDS) {
+        const u64* block = set->words + i;
+        if (block[0] | block[1] | block[2] | block[3]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+u64 bitset_find_next(const bitset* set, u64 from) {
+    if (from >= set->bit_count) {
+        return set->bit_count;
+    }
+
+    u64 word_index = from >> 6;
+    u64 word = set->words[word_index] & (~(u64)0 << (from & 63));
+    for (;;) {
+        if (word) {
+            // Bits past bit_count are 0, so anything found is in range
+            return (word_index << 6) + (u64)__builtin_ctzll(word);
+        }
+        if (++word_index >= set->word_count) {
+            return set->bit_count;
+        }
+
+        // Skip empty blocks whole
+        while ((word_index % BITSET_BLOCK_WORDS) == 0 && word_index < set->word_count) {
+            const u64* block = set->words + word_index;
+            if (block[0] | block[1] | block[2] | block[3]) {
+                break;
+            }
+            word_index += BITSET_BLOCK_WORDS;
+        }
+        if (word_index >= set->word_count) {
+            return set->bit_count;
+        }
+        word = set->words[word_index];
+    }
+}
+
+static b8 sizes_match(const bitset* out, const bitset* a, const bitset* b) {
+    if (out->bit_count != a->bit_count || a->bit_count != b->bit_count) {
+        PE_ERROR("bitset - bulk operation on bitsets of different sizes (%llu, %llu, %llu bits).", out->bit_count, a->bit_count, b->bit_count);
+        return false;
+    }
+    return true;
+}
+
+void bitset_and(bitset* out, const bitset* a, const bitset* b) {
+    if (!sizes_match(out, a, b)) {
+        return;
+    }
+    for (u64 i = 0; i < out->word_count; i += BITSET_BLOCK_WORDS) {
+#if defined(__AVX2__)
+        __m256i result = _mm256_and_si256(_mm256_load_si256((const __m256i*)(a->words + i)), _mm256_load_si256((const __m256i*)(b->words + i)));
+        _mm256_store_si256((__m256i*)(out->words + i), result);
+#elif BITSET_SSE2
+        for (u64 j = i; j < i + BITSET_BLOCK_WORDS; j += 2) {
+            __m128i result = _mm_and_si128(_mm_load_si128((const __m128i*)(a->words + j)), _mm_load_si128((const __m128i*)(b->words + j)));
+            _mm_store_si128((__m128i*)(out->words + j), result);
+        }
+#else
+        for (u64 j = i; j < i + BITSET_BLOCK_WORDS; ++j) {
+            out->words[j] = a->words[j] & b->words[j];
+        }
+#endif
+    }
+}
+
+void bitset_or(bitset* out, const bitset* a, const bitset* b) {
+    if (!sizes_match(out, a, b)) {
+        return;
+    }
+    for (u64 i = 0; i < out->word_count; i += BITSET_BLOCK_WORDS) {
+#if defined(__AVX2__)
+        __m256i result = _mm256_or_si256(_mm256_load_si256((const __m256i*)(a->words + i)), _mm256_load_si256((const __m256i*)(b->words + i)));
+        _mm256_store_si256((__m256i*)(out->words + i), result);
+#elif BITSET_SSE2
+        for (u64 j = i; j < i + BITSET_BLOCK_WORDS; j += 2) {
+            __m128i result = _mm_or_si128(_mm_load_si128((const __m128i*)(a->words + j)), _mm_load_si128((const __m128i*)(b->words + j)));
+            _mm_store_si128((__m128i*)(out->words + j), result);
+        }
+#else
+        for (u64 j = i; j < i + BITSET_BLOCK_WORDS; ++j) {
+            out->words[j] = a->words[j] | b->words[j];
+        }
+#endif
+    }
+}
+
+void bitset_andnot(bitset* out, const bitset* a, const bitset* b) {
+    if (!sizes_match(out, a, b)) {
+        return;
+    }
+    for (u64 i = 0; i < out->word_count; i += BITSET_BLOCK_WORDS) {
+        // The intrinsics compute ~first & second
+#if defined(__AVX2__)
+        __m256i result = _mm256_andnot_si256(_mm256_load_si256((const __m256i*)(b->words + i)), _mm256_load_si256((const __m256i*)(a->words + i)));
+        _mm256_store_si256((__m256i*)(out->words + i), result);
+#elif BITSET_SSE2
+        for (u64 j = i; j < i + BITSET_BLOCK_WORDS; j += 2) {
+            __m128i result = _mm_andnot_si128(_mm_load_si128((const __m128i*)(b->words + j)), _mm_load_si128((const __m128i*)(a->words + j)));
+            _mm_store_si128((__m128i*)(out->words + j), result);
+        }
+#else
+        for (u64 j = i; j < i + BITSET_BLOCK_WORDS; ++j) {
+            out->words[j] = a->words[j] & ~b->words[j];
+        }
+#endif
+    }
+}
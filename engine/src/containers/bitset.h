@@ -0,0 +1,74 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Dynamically sized set of bits, packed 64 to a word.
+
+Words are allocated in blocks of BITSET_BLOCK_WORDS (256 bits) on a 32 byte boundary, and bits
+past bit_count are always 0, so bulk operations and counts run a whole block at a time
+(AVX2 when the engine is built with it, SSE2 otherwise) without handling a tail.
+*/
+
+#define BITSET_BLOCK_WORDS 4
+
+typedef struct bitset {
+    u64 bit_count;
+    // A multiple of BITSET_BLOCK_WORDS
+    u64 word_count;
+    u64* words;
+} bitset;
+
+/**
+ * @brief Creates a bitset with every bit cleared.
+ *
+ * @param bit_count The number of bits
+ * @param out_bitset A pointer to hold the bitset
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 bitset_create(u64 bit_count, bitset* out_bitset);
+PE_API void bitset_destroy(bitset* set);
+
+// Changes the number of bits. Bits kept keep their values; new bits are cleared.
+PE_API b8 bitset_resize(bitset* set, u64 bit_count);
+
+PE_INLINE void bitset_set(bitset* set, u64 bit) {
+    set->words[bit >> 6] |= (u64)1 << (bit & 63);
+}
+
+PE_INLINE void bitset_clear(bitset* set, u64 bit) {
+    set->words[bit >> 6] &= ~((u64)1 << (bit & 63));
+}
+
+PE_INLINE void bitset_assign(bitset* set, u64 bit, b8 value) {
+    u64 mask = (u64)1 << (bit & 63);
+    u64* word = &set->words[bit >> 6];
+    *word = (*word & ~mask) | (value ? mask : 0);
+}
+
+PE_INLINE b8 bitset_test(const bitset* set, u64 bit) {
+    return (set->words[bit >> 6] >> (bit & 63)) & 1;
+}
+
+PE_API void bitset_set_all(bitset* set);
+PE_API void bitset_clear_all(bitset* set);
+
+// Number of set bits
+PE_API u64 bitset_count(const bitset* set);
+PE_API b8 bitset_any(const bitset* set);
+
+/**
+ * @brief Finds the first set bit at or after from. Iterate the set bits with
+ * for (u64 i = bitset_find_next(set, 0); i < set->bit_count; i = bitset_find_next(set, i + 1))
+ *
+ * @returns The index of the bit, or bit_count if there is none.
+ */
+PE_API u64 bitset_find_next(const bitset* set, u64 from);
+
+// Bulk operations. All bitsets must have the same bit_count; out may be a or b.
+// out = a & b
+PE_API void bitset_and(bitset* out, const bitset* a, const bitset* b);
+// out = a | b
+PE_API void bitset_or(bitset* out, const bitset* a, const bitset* b);
+// out = a & ~b, e.g. the bits of a not yet handled in b
+PE_API void bitset_andnot(bitset* out, const bitset* a, const bitset* b);
@@ -3,112 +3,216 @@
 #include "core/pe_memory.h"
 #include "core/logger.h"
 
-void* _darray_create(u64 length, u64 stride) {
-    u64 header_size = DARRAY_FIELD_LENGTH * sizeof(u64);
+#define DARRAY_HEADER_SIZE (DARRAY_FIELD_LENGTH * sizeof(u64))
+
+static u64* darray_allocate(u64 length, u64 stride, b8 zeroed) {
     u64 array_size = length * stride;
-    u64* new_array = pe_allocate(header_size + array_size, MEMORY_TAG_DARRAY);
-    pe_set_memory(new_array, 0, header_size + array_size);
+    if (zeroed) {
+        return pe_allocate(DARRAY_HEADER_SIZE + array_size, MEMORY_TAG_DARRAY);
+    }
+    return pe_allocate_uninit(DARRAY_HEADER_SIZE + array_size, MEMORY_TAG_DARRAY);
+}
+
+// Changes the capacity, in place where the allocator can. Elements past the old capacity are undefined.
+// Returns 0 on failure, leaving the array as it was.
+static void* darray_set_capacity(void* array, u64 capacity) {
+    u64* header = _darray_header(array);
+    u64 stride = header[DARRAY_STRIDE];
+    u64 old_size = DARRAY_HEADER_SIZE + header[DARRAY_CAPACITY] * stride;
+    u64 new_size = DARRAY_HEADER_SIZE + capacity * stride;
+
+    u64* new_header = pe_reallocate(header, old_size, new_size, MEMORY_TAG_DARRAY);
+    if (!new_header) {
+        PE_ERROR("darray - failed to resize to a capacity of %llu elements.", capacity);
+        return 0;
+    }
+    new_header[DARRAY_CAPACITY] = capacity;
+    return new_header + DARRAY_FIELD_LENGTH;
+}
+
+// Makes room for at least min_capacity elements, growing geometrically so repeated growth stays amortized O(1).
+// Returns 0 on failure, leaving the array as it was.
+static void* darray_grow(void* array, u64 min_capacity) {
+    u64 capacity = DARRAY_RESIZE_FACTOR * darray_capacity(array);
+    if (capacity < DARRAY_DEFAULT_CAPACITY) {
+        capacity = DARRAY_DEFAULT_CAPACITY;
+    }
+    if (capacity < min_capacity) {
+        capacity = min_capacity;
+    }
+    return darray_set_capacity(array, capacity);
+}
+
+// Returns 0 if the array couldn't grow, leaving it as it was
+static void* darray_ensure_capacity(void* array, u64 required) {
+    if (required > darray_capacity(array)) {
+        return darray_grow(array, required);
+    }
+    return array;
+}
+
+void* _darray_create(u64 length, u64 stride) {
+    // Zeroed, since callers may fill reserved elements by index before setting the length
+    u64* new_array = darray_allocate(length, stride, true);
+    if (!new_array) {
+        PE_ERROR("darray - failed to create an array of %llu elements.", length);
+        return 0;
+    }
     new_array[DARRAY_CAPACITY] = length;
-    new_array[DARRAY_FIELD_LENGTH] = 0;
+    new_array[DARRAY_LENGTH] = 0;
     new_array[DARRAY_STRIDE] = stride;
 
     return (void*)(new_array + DARRAY_FIELD_LENGTH);
 }
 
 void _darray_destroy(void* array) {
-    u64* header = (u64*)array - DARRAY_FIELD_LENGTH;
-    u64 header_size = DARRAY_FIELD_LENGTH * sizeof(u64);
-    u64 total_size = header_size + header[DARRAY_CAPACITY] * header[DARRAY_STRIDE];
+    u64* header = _darray_header(array);
+    u64 total_size = DARRAY_HEADER_SIZE + header[DARRAY_CAPACITY] * header[DARRAY_STRIDE];
     pe_free(header, total_size, MEMORY_TAG_DARRAY);
 }
 
 u64 _darray_field_get(void* array, u64 field) {
-    u64* header = (u64*)array - DARRAY_FIELD_LENGTH;
+    u64* header = _darray_header(array);
     return header[field];
 }
 
 void _darray_field_set(void* array, u64 field, u64 value) {
-    u64* header = (u64*)array - DARRAY_FIELD_LENGTH;
+    u64* header = _darray_header(array);
     header[field] = value;
 }
 
 void* _darray_resize(void* array) {
-    u64 length = darray_length(array);
-    u64 stride = darray_stride(array);
-    void* temp = _darray_create(
-        (DARRAY_RESIZE_FACTOR * darray_capacity(array)),
-        stride);
-    pe_copy_memory(temp, array, length * stride);
+    void* grown = darray_grow(array, darray_capacity(array) + 1);
+    return grown ? grown : array;
+}
+
+void* _darray_reserve_more(void* array, u64 count) {
+    void* reserved = darray_ensure_capacity(array, darray_length(array) + count);
+    return reserved ? reserved : array;
+}
 
-    _darray_field_set(temp, DARRAY_LENGTH, length);
-    _darray_destroy(array);
-    return temp;
+void* _darray_shrink_to_fit(void* array) {
+    u64 length = darray_length(array);
+    if (length == darray_capacity(array)) {
+        return array;
+    }
+    void* shrunk = darray_set_capacity(array, length);
+    return shrunk ? shrunk : array;
 }
 
 void* _darray_push(void* array, const void* value_ptr) {
     u64 length = darray_length(array);
     u64 stride = darray_stride(array);
-    if (length >= darray_capacity(array)) {
-        array = _darray_resize(array);
+    void* grown = darray_ensure_capacity(array, length + 1);
+    if (!grown) {
+        // Dropped rather than written past the end
+        return array;
     }
+    array = grown;
 
     u64 addr = (u64)array;
     addr += (length * stride);
     pe_copy_memory((void*)addr, value_ptr, stride);
-    _darray_field_set(array, DARRAY_LENGTH, length + 1);
+    darray_length_set(array, length + 1);
 
     return array;
 }
 
+void* _darray_append_n(void* array, const void* values, u64 count) {
+    if (count == 0) {
+        return array;
+    }
+
+    u64 length = darray_length(array);
+    u64 stride = darray_stride(array);
+    void* grown = darray_ensure_capacity(array, length + count);
+    if (!grown) {
+        return array;
+    }
+    array = grown;
+
+    pe_copy_memory((u8*)array + length * stride, values, count * stride);
+    darray_length_set(array, length + count);
+    return array;
+}
+
 void _darray_pop(void* array, void* dst) {
     u64 length = darray_length(array);
     u64 stride = darray_stride(array);
+    if (length == 0) {
+        PE_ERROR("darray_pop called on an empty array.");
+        return;
+    }
     u64 addr = (u64)array;
     addr += ((length - 1) * stride);
     pe_copy_memory(dst, (void*)addr, stride);
-    _darray_field_set(array, DARRAY_LENGTH, length - 1);
+    darray_length_set(array, length - 1);
 }
 
 void* _darray_pop_at(void* array, u64 index, void* dst) {
     u64 length = darray_length(array);
     u64 stride = darray_stride(array);
     if (index >= length) {
-        PE_ERROR("Index outside the bounds of this array! Length %i, index: %i, length, indeks");
+        PE_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
         return array;
     }
 
-    u64 addr = (u64)array;
-    pe_copy_memory(dst, (void*)(addr + (index * stride)), stride);
+    u8* element = (u8*)array + index * stride;
+    if (dst) {
+        pe_copy_memory(dst, element, stride);
+    }
 
-    // If not on the last element, snip out the entry and copy the rest inward
+    // If not on the last element, snip out the entry and move the rest inward
     if (index != length - 1) {
-        // TODO: replace copying from close addresses
-        pe_copy_memory(
-            (void*)(addr + (index * stride)),
-            (void*)(addr + ((index + 1) * stride)),
-            stride * (length - (index + 1)));
+        pe_move_memory(element, element + stride, stride * (length - (index + 1)));
     }
 
-    _darray_field_set(array, DARRAY_LENGTH, length - 1);
+    darray_length_set(array, length - 1);
     return array;
 }
 
-void* _darray_insert_alt(void* array, u64 index, void* value_ptr) {
+void* _darray_swap_remove(void* array, u64 index, void* dst) {
     u64 length = darray_length(array);
     u64 stride = darray_stride(array);
     if (index >= length) {
-        PE_ERROR("Index outside the bounds of this array! Length: %i, index: %i", length, index);
+        PE_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
         return array;
     }
-    if (length >= darray_capacity(array)) {
-        array = _darray_resize(array);
+
+    u8* element = (u8*)array + index * stride;
+    if (dst) {
+        pe_copy_memory(dst, element, stride);
     }
 
-    u64 addr = (u64)array;
+    // Fill the hole with the last element
+    if (index != length - 1) {
+        pe_copy_memory(element, (u8*)array + (length - 1) * stride, stride);
+    }
+
+    darray_length_set(array, length - 1);
+    return array;
+}
+
+void* _darray_insert_at(void* array, u64 index, const void* value_ptr) {
+    u64 length = darray_length(array);
+    u64 stride = darray_stride(array);
+    if (index > length) {
+        PE_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
+        return array;
+    }
+    void* grown = darray_ensure_capacity(array, length + 1);
+    if (!grown) {
+        return array;
+    }
+    array = grown;
 
-    // If not on the last element, copy the rest onward.
-    pe_copy_memory((void*)(addr + (index * stride)), value_ptr, stride);
+    // Move the rest onward to open a slot
+    u8* element = (u8*)array + index * stride;
+    if (index != length) {
+        pe_move_memory(element + stride, element, stride * (length - index));
+    }
+    pe_copy_memory(element, value_ptr, stride);
 
-    _darray_field_set(array, DARRAY_LENGTH, length + 1);
+    darray_length_set(array, length + 1);
     return array;
-}
\ No newline at end of file
+}
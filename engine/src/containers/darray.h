@@ -18,23 +18,48 @@ enum {
     DARRAY_FIELD_LENGTH
 };
 
+// Returns 0, after logging an error, if the memory can't be allocated
 PE_API void* _darray_create(u64 length, u64 stride);
 PE_API void _darray_destroy(void* array);
 
+// Exported for existing callers; the macros below read the header inline instead
 PE_API u64 _darray_field_get(void* array, u64 field);
 PE_API void _darray_field_set(void* array, u64 field, u64 value);
 
+// The header fields sit just in front of the elements
+PE_INLINE u64* _darray_header(const void* array) {
+    return (u64*)array - DARRAY_FIELD_LENGTH;
+}
+
+// Functions that grow the array return it, possibly moved. If it can't grow, they log an error and
+// return it unchanged, without adding anything.
+
+// Grows the capacity by DARRAY_RESIZE_FACTOR, in place when the memory behind the array is free
 PE_API void* _darray_resize(void* array);
 
+// Ensures room for count more elements without further growth
+PE_API void* _darray_reserve_more(void* array, u64 count);
+
+// Drops unused capacity, so the array holds exactly its length
+PE_API void* _darray_shrink_to_fit(void* array);
+
 PE_API void* _darray_push(void* array, const void* value_ptr);
+// Appends count elements from values, growing at most once
+PE_API void* _darray_append_n(void* array, const void* values, u64 count);
+// Logs an error and leaves dst untouched if the array is empty
 PE_API void _darray_pop(void* array, void* dst);
 
+// Removes the element at index, moving later elements down to keep the order. dst may be 0.
 PE_API void* _darray_pop_at(void* array, u64 index, void* dst);
-PE_API void* _darray_insert_at(void* array, u64 index, void* value_ptr);
+// Removes the element at index by moving the last element into its place. O(1), but doesn't keep the order. dst may be 0.
+PE_API void* _darray_swap_remove(void* array, u64 index, void* dst);
+// Inserts before the element at index, moving later elements up. An index equal to the length appends.
+PE_API void* _darray_insert_at(void* array, u64 index, const void* value_ptr);
 
-#define DARRAY_DEFAULT_CAPACITY 1
+#define DARRAY_DEFAULT_CAPACITY 4
 #define DARRAY_RESIZE_FACTOR 2
 
+// darray_create and darray_reserve return 0 if the engine heap is exhausted or the DARRAY budget is hit
 #define darray_create(type) \
     _darray_create(DARRAY_DEFAULT_CAPACITY, sizeof(type))
 
@@ -43,35 +68,66 @@ PE_API void* _darray_insert_at(void* array, u64 index, void* value_ptr);
 
 #define darray_destroy(array) _darray_destroy(array)
 
-#define darray_push(array, value)           \
-    {                                       \
-        typeof(value) temp = value;         \
-        array = _darray_push(array, &temp); \
+// value is converted to the element type, so literals and const values can be pushed. Stores straight
+// into the array unless it has to grow. Locals use reserved names so they can't shadow the caller's.
+#define darray_push(array, value)                                                  \
+    {                                                                              \
+        typeof(*(array)) __darray_temp = (value);                                  \
+        u64* __darray_header = _darray_header(array);                              \
+        if (__darray_header[DARRAY_LENGTH] < __darray_header[DARRAY_CAPACITY]) {   \
+            ((typeof(*(array))*)(array))[__darray_header[DARRAY_LENGTH]++] = __darray_temp; \
+        } else {                                                                   \
+            array = _darray_push(array, &__darray_temp);                           \
+        }                                                                          \
     }
 
-#define darray_pop(array, value_ptr) \
-    _darray_pop(array, value_ptr)
+#define darray_append_n(array, values_ptr, count) \
+    array = _darray_append_n(array, values_ptr, count)
+
+#define darray_reserve_more(array, count) \
+    array = _darray_reserve_more(array, count)
+
+#define darray_shrink_to_fit(array) \
+    array = _darray_shrink_to_fit(array)
+
+// The element is converted to *value_ptr's type. Popping an empty array logs an error and leaves *value_ptr as it was.
+#define darray_pop(array, value_ptr)                                             \
+    {                                                                            \
+        u64* __darray_header = _darray_header(array);                            \
+        if (__darray_header[DARRAY_LENGTH]) {                                    \
+            *(value_ptr) = (array)[--__darray_header[DARRAY_LENGTH]];            \
+        } else {                                                                 \
+            /* Only logs the error */                                            \
+            _darray_pop(array, value_ptr);                                       \
+        }                                                                        \
+    }
 
-#define darray_insert_at(array, index, value)           \
-    {                                                   \
-        typeof(value) temp = value;                     \
-        array = _darray_insert_at(array, index, &temp); \
+#define darray_insert_at(array, index, value)                    \
+    {                                                            \
+        typeof(*(array)) __darray_temp = (value);                \
+        array = _darray_insert_at(array, index, &__darray_temp); \
     }
 
 #define darray_pop_at(array, index, value_ptr) \
     _darray_pop_at(array, index, value_ptr)
 
+#define darray_remove_at(array, index) \
+    _darray_pop_at(array, index, 0)
+
+#define darray_swap_remove(array, index, value_ptr) \
+    _darray_swap_remove(array, index, value_ptr)
+
 #define darray_clear(array) \
-    _darray_field_set(array, DARRAY_LENGTH, 0)
+    (_darray_header(array)[DARRAY_LENGTH] = 0)
 
-#define darray_capacity(arra) \
-    _darray_field_get(array, DARRAY_CAPACITY)
+#define darray_capacity(array) \
+    ((u64)_darray_header(array)[DARRAY_CAPACITY])
 
 #define darray_length(array) \
-    _darray_field_get(array, DARRAY_LENGTH)
+    ((u64)_darray_header(array)[DARRAY_LENGTH])
 
 #define darray_stride(array) \
-    _darray_field_get(array, DARRAY_STRIDE)
+    ((u64)_darray_header(array)[DARRAY_STRIDE])
 
 #define darray_length_set(array, value) \
-    _darray_field_set(aray, DARRAY_LENGTH, value)
\ No newline at end of file
+    (_darray_header(array)[DARRAY_LENGTH] = (value))
@@ -0,0 +1,282 @@
+#include "containers/hashtable.h"
+
+#include "core/pe_memory.h"
+#include "core/pe_string.h"
+#include "core/logger.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define HASHTABLE_SSE2 1
+#endif
+
+// Control byte of an empty slot. Full slots hold 7 hash bits, so the high bit tells them apart.
+#define CONTROL_EMPTY 0x80
+
+#define MIN_CAPACITY HASHTABLE_GROUP_WIDTH
+#define BLOCK_ALIGNMENT 16
+
+static u64 hash_key(const char* key) {
+    return string_hash(key, string_length(key));
+}
+
+PE_INLINE u8 hash_control(u64 hash) {
+    return (u8)(hash >> 57);
+}
+
+// Bit i set for each of the group's control bytes equal to value
+PE_INLINE u32 group_match(const u8* group, u8 value) {
+#if HASHTABLE_SSE2
+    __m128i bytes = _mm_loadu_si128((const __m128i*)group);
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)value)));
+#else
+    u32 mask = 0;
+    for (u32 i = 0; i < HASHTABLE_GROUP_WIDTH; ++i) {
+        mask |= (u32)(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+// Bit i set for each empty slot in the group
+PE_INLINE u32 group_match_empty(const u8* group) {
+#if HASHTABLE_SSE2
+    // Only empty slots have the high bit set
+    return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    return group_match(group, CONTROL_EMPTY);
+#endif
+}
+
+static void set_control(hashtable* table, u64 index, u8 value) {
+    table->control[index] = value;
+    // Keep the copy past the end in step
+    if (index < HASHTABLE_GROUP_WIDTH - 1) {
+        table->control[table->capacity + index] = value;
+    }
+}
+
+PE_INLINE u8* value_at(const hashtable* table, u64 index) {
+    return table->values + index * table->element_size;
+}
+
+/**
+ * Probes for key. Returns true with out_index at its slot if present; otherwise false with
+ * out_index at the empty slot where it would go.
+ */
+static b8 find_slot(const hashtable* table, const char* key, u64 hash, u64* out_index) {
+    u64 mask = table->capacity - 1;
+    u8 control = hash_control(hash);
+    u64 position = hash & mask;
+    for (;;) {
+        const u8* group = table->control + position;
+        u32 empties = group_match_empty(group);
+        // Linear probing never places a key past an empty slot in its probe sequence
+        u32 limit = empties ? (u32)__builtin_ctz(empties) : HASHTABLE_GROUP_WIDTH;
+        u32 matches = group_match(group, control) & ((1u << limit) - 1);
+        while (matches) {
+            u64 index = (position + __builtin_ctz(matches)) & mask;
+            const hashtable_slot* slot = &table->slots[index];
+            if (slot->hash == hash && strings_equal(slot->key, key)) {
+                *out_index = index;
+                return true;
+            }
+            matches &= matches - 1;
+        }
+        if (empties) {
+            *out_index = (position + limit) & mask;
+            return false;
+        }
+        position = (position + HASHTABLE_GROUP_WIDTH) & mask;
+    }
+}
+
+// First empty slot for a hash known not to be in the table
+static u64 find_empty_slot(const hashtable* table, u64 hash) {
+    u64 mask = table->capacity - 1;
+    u64 position = hash & mask;
+    for (;;) {
+        u32 empties = group_match_empty(table->control + position);
+        if (empties) {
+            return (position + __builtin_ctz(empties)) & mask;
+        }
+        position = (position + HASHTABLE_GROUP_WIDTH) & mask;
+    }
+}
+
+static u64 capacity_for(u64 element_count) {
+    // Stay at or below 7/8 full
+    u64 required = element_count + element_count / 7 + 1;
+    u64 capacity = MIN_CAPACITY;
+    while (capacity < required) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// Moves every entry into a new block of the given capacity
+static b8 rehash(hashtable* table, u64 capacity) {
+    u64 control_size = pe_align_up(capacity + HASHTABLE_GROUP_WIDTH - 1, BLOCK_ALIGNMENT);
+    u64 slots_size = capacity * sizeof(hashtable_slot);
+    u64 values_size = pe_align_up(capacity * table->element_size, BLOCK_ALIGNMENT);
+    u64 memory_size = control_size + slots_size + values_size;
+
+    u8* memory = pe_allocate_uninit(memory_size, MEMORY_TAG_DICT);
+    if (!memory) {
+        PE_ERROR("hashtable - failed to allocate %llu slots.", capacity);
+        return false;
+    }
+
+    hashtable old = *table;
+    table->capacity = capacity;
+    table->growth_limit = capacity - capacity / 8;
+    table->control = memory;
+    table->slots = (hashtable_slot*)(memory + control_size);
+    table->values = memory + control_size + slots_size;
+    table->memory_size = memory_size;
+    pe_set_memory(table->control, CONTROL_EMPTY, capacity + HASHTABLE_GROUP_WIDTH - 1);
+
+    if (old.control) {
+        for (u64 i = 0; i < old.capacity; ++i) {
+            if (old.control[i] & CONTROL_EMPTY) {
+                continue;
+            }
+            u64 index = find_empty_slot(table, old.slots[i].hash);
+            set_control(table, index, old.control[i]);
+            table->slots[index] = old.slots[i];
+            pe_copy_memory(value_at(table, index), value_at(&old, i), table->element_size);
+        }
+        pe_free(old.control, old.memory_size, MEMORY_TAG_DICT);
+    }
+
+    return true;
+}
+
+static void free_key(char* key) {
+    pe_free(key, string_length(key) + 1, MEMORY_TAG_DICT);
+}
+
+b8 hashtable_create(u64 element_size, u64 element_count, hashtable* out_table) {
+    if (!out_table) {
+        PE_ERROR("hashtable_create - requires a pointer to hold the table.");
+        return false;
+    }
+
+    pe_zero_memory(out_table, sizeof(hashtable));
+    out_table->element_size = element_size;
+    return rehash(out_table, capacity_for(element_count));
+}
+
+void hashtable_destroy(hashtable* table) {
+    if (!table || !table->control) {
+        return;
+    }
+
+    hashtable_clear(table);
+    pe_free(table->control, table->memory_size, MEMORY_TAG_DICT);
+    pe_zero_memory(table, sizeof(hashtable));
+}
+
+b8 hashtable_reserve(hashtable* table, u64 element_count) {
+    if (element_count <= table->growth_limit) {
+        return true;
+    }
+    return rehash(table, capacity_for(element_count));
+}
+
+b8 hashtable_set(hashtable* table, const char* key, const void* value) {
+    if (!table || !table->control || !key) {
+        PE_ERROR("hashtable_set - requires a valid table and key.");
+        return false;
+    }
+
+    u64 hash = hash_key(key);
+    u64 index;
+    if (!find_slot(table, key, hash, &index)) {
+        if (table->count >= table->growth_limit) {
+            if (!rehash(table, table->capacity * 2)) {
+                return false;
+            }
+            index = find_empty_slot(table, hash);
+        }
+
+        u64 key_size = string_length(key) + 1;
+        char* key_copy = pe_allocate_uninit(key_size, MEMORY_TAG_DICT);
+        if (!key_copy) {
+            return false;
+        }
+        pe_copy_memory(key_copy, key, key_size);
+
+        set_control(table, index, hash_control(hash));
+        table->slots[index].hash = hash;
+        table->slots[index].key = key_copy;
+        table->count++;
+    }
+
+    if (value) {
+        pe_copy_memory(value_at(table, index), value, table->element_size);
+    } else {
+        pe_zero_memory(value_at(table, index), table->element_size);
+    }
+    return true;
+}
+
+void* hashtable_get(const hashtable* table, const char* key) {
+    if (!table || !table->control || !key) {
+        return 0;
+    }
+
+    u64 index;
+    if (!find_slot(table, key, hash_key(key), &index)) {
+        return 0;
+    }
+    return value_at(table, index);
+}
+
+b8 hashtable_contains(const hashtable* table, const char* key) {
+    u64 index;
+    return table && table->control && key && find_slot(table, key, hash_key(key), &index);
+}
+
+b8 hashtable_remove(hashtable* table, const char* key) {
+    if (!table || !table->control || !key) {
+        return false;
+    }
+
+    u64 hole;
+    if (!find_slot(table, key, hash_key(key), &hole)) {
+        return false;
+    }
+    free_key(table->slots[hole].key);
+    table->count--;
+
+    // Shift back each following entry whose home slot is at or before the hole, so every
+    // entry stays reachable from its home without crossing an empty slot
+    u64 mask = table->capacity - 1;
+    for (u64 next = (hole + 1) & mask; !(table->control[next] & CONTROL_EMPTY); next = (next + 1) & mask) {
+        u64 home = table->slots[next].hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            set_control(table, hole, table->control[next]);
+            table->slots[hole] = table->slots[next];
+            pe_copy_memory(value_at(table, hole), value_at(table, next), table->element_size);
+            hole = next;
+        }
+    }
+    set_control(table, hole, CONTROL_EMPTY);
+
+    return true;
+}
+
+void hashtable_clear(hashtable* table) {
+    if (!table || !table->control) {
+        return;
+    }
+
+    for (u64 i = 0; i < table->capacity && table->count; ++i) {
+        if (!(table->control[i] & CONTROL_EMPTY)) {
+            free_key(table->slots[i].key);
+            table->count--;
+        }
+    }
+    table->count = 0;
+    pe_set_memory(table->control, CONTROL_EMPTY, table->capacity + HASHTABLE_GROUP_WIDTH - 1);
+}
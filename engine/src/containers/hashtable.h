@@ -0,0 +1,75 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Open-addressing hash table keyed by strings, holding fixed-size values.
+
+One allocation per capacity holds, in order:
+u8 control[capacity + HASHTABLE_GROUP_WIDTH - 1] = 7 bits of each slot's hash, or empty.
+    The first GROUP_WIDTH - 1 bytes are repeated at the end so any group can be loaded without wrapping.
+hashtable_slot slots[capacity] = full hash and key of each slot
+values[capacity * element_size]
+
+Lookups scan the control bytes a group at a time (SSE2 where available), so only slots whose
+7 hash bits match are looked at, and only keys whose full hash matches are compared.
+Linear probing lets removal shift later entries back instead of leaving tombstones.
+*/
+
+// Control bytes matched per step of a probe
+#define HASHTABLE_GROUP_WIDTH 16
+
+typedef struct hashtable_slot {
+    u64 hash;
+    // Owned copy of the key
+    char* key;
+} hashtable_slot;
+
+typedef struct hashtable {
+    u64 element_size;
+    // Slot count, a power of two
+    u64 capacity;
+    u64 count;
+    // Count at which the table grows, keeping at least an eighth of the slots empty
+    u64 growth_limit;
+    u8* control;
+    hashtable_slot* slots;
+    u8* values;
+    // Size of the block starting at control
+    u64 memory_size;
+} hashtable;
+
+/**
+ * @brief Creates a hash table with room for element_count entries before it has to grow.
+ *
+ * @param element_size The size of each value in bytes. 0 for a set of keys.
+ * @param element_count The number of entries to preallocate for
+ * @param out_table A pointer to hold the table
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 hashtable_create(u64 element_size, u64 element_count, hashtable* out_table);
+PE_API void hashtable_destroy(hashtable* table);
+
+// Grows the table so it holds element_count entries without growing again. Never shrinks.
+PE_API b8 hashtable_reserve(hashtable* table, u64 element_count);
+
+/**
+ * @brief Adds key with a copy of value, or overwrites the value if key is already present.
+ *
+ * @param table The table
+ * @param key The key. Copied into the table.
+ * @param value element_size bytes to store. 0 stores zeros.
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 hashtable_set(hashtable* table, const char* key, const void* value);
+
+// Returns the value stored for key, or 0 if key is not present. Valid until the table is next modified.
+PE_API void* hashtable_get(const hashtable* table, const char* key);
+
+PE_API b8 hashtable_contains(const hashtable* table, const char* key);
+
+// Removes key and its value. Returns false if key was not present.
+PE_API b8 hashtable_remove(hashtable* table, const char* key);
+
+// Removes every entry, keeping the capacity
+PE_API void hashtable_clear(hashtable* table);
@@ -0,0 +1,230 @@
+#include "containers/ring_queue.h"
+
+#include "core/pe_memory.h"
+#include "core/logger.h"
+
+static u64 round_capacity(u64 capacity) {
+    u64 rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+// Allocates a buffer starting on its own cache line, so elements don't share a line with other data
+static u8* allocate_buffer(u64 size) {
+    return pe_allocate_aligned(size, PE_CACHE_LINE_SIZE, MEMORY_TAG_RING_QUEUE);
+}
+
+static void free_buffer(u8* buffer, u64 size) {
+    pe_free_aligned(buffer, size, PE_CACHE_LINE_SIZE, MEMORY_TAG_RING_QUEUE);
+}
+
+PE_INLINE u8* element_at(u8* buffer, u64 element_size, u64 slot) {
+    return buffer + slot * element_size;
+}
+
+// Single-threaded
+
+b8 ring_queue_create(u64 element_size, u64 capacity, ring_queue* out_queue) {
+    if (!out_queue || element_size == 0) {
+        PE_ERROR("ring_queue_create - requires an element size above 0 and a pointer to hold the queue.");
+        return false;
+    }
+
+    pe_zero_memory(out_queue, sizeof(ring_queue));
+    out_queue->element_size = element_size;
+    out_queue->capacity = round_capacity(capacity);
+    out_queue->mask = out_queue->capacity - 1;
+    out_queue->buffer = allocate_buffer(out_queue->capacity * element_size);
+    return out_queue->buffer != 0;
+}
+
+void ring_queue_destroy(ring_queue* queue) {
+    if (queue && queue->buffer) {
+        free_buffer(queue->buffer, queue->capacity * queue->element_size);
+        pe_zero_memory(queue, sizeof(ring_queue));
+    }
+}
+
+b8 ring_queue_push(ring_queue* queue, const void* value) {
+    if (queue->tail - queue->head == queue->capacity) {
+        return false;
+    }
+    pe_copy_memory(element_at(queue->buffer, queue->element_size, queue->tail & queue->mask), value, queue->element_size);
+    queue->tail++;
+    return true;
+}
+
+b8 ring_queue_pop(ring_queue* queue, void* out_value) {
+    if (!ring_queue_peek(queue, out_value)) {
+        return false;
+    }
+    queue->head++;
+    return true;
+}
+
+b8 ring_queue_peek(const ring_queue* queue, void* out_value) {
+    if (queue->head == queue->tail) {
+        return false;
+    }
+    pe_copy_memory(out_value, element_at(queue->buffer, queue->element_size, queue->head & queue->mask), queue->element_size);
+    return true;
+}
+
+u64 ring_queue_length(const ring_queue* queue) {
+    return queue->tail - queue->head;
+}
+
+// Single producer, single consumer
+
+b8 ring_queue_spsc_create(u64 element_size, u64 capacity, ring_queue_spsc* out_queue) {
+    if (!out_queue || element_size == 0) {
+        PE_ERROR("ring_queue_spsc_create - requires an element size above 0 and a pointer to hold the queue.");
+        return false;
+    }
+
+    pe_zero_memory(out_queue, sizeof(ring_queue_spsc));
+    out_queue->element_size = element_size;
+    out_queue->capacity = round_capacity(capacity);
+    out_queue->mask = out_queue->capacity - 1;
+    out_queue->buffer = allocate_buffer(out_queue->capacity * element_size);
+    return out_queue->buffer != 0;
+}
+
+void ring_queue_spsc_destroy(ring_queue_spsc* queue) {
+    if (queue && queue->buffer) {
+        free_buffer(queue->buffer, queue->capacity * queue->element_size);
+        pe_zero_memory(queue, sizeof(ring_queue_spsc));
+    }
+}
+
+b8 ring_queue_spsc_push(ring_queue_spsc* queue, const void* value) {
+    // Only this thread writes tail
+    u64 tail = PE_ATOMIC_LOAD(&queue->tail, PE_ATOMIC_RELAXED);
+    if (tail - queue->cached_head == queue->capacity) {
+        // Acquire pairs with the consumer's release, so it is done reading the slot about to be reused
+        queue->cached_head = PE_ATOMIC_LOAD(&queue->head, PE_ATOMIC_ACQUIRE);
+        if (tail - queue->cached_head == queue->capacity) {
+            return false;
+        }
+    }
+
+    pe_copy_memory(element_at(queue->buffer, queue->element_size, tail & queue->mask), value, queue->element_size);
+    // Publishes the element along with the new tail
+    PE_ATOMIC_STORE(&queue->tail, tail + 1, PE_ATOMIC_RELEASE);
+    return true;
+}
+
+b8 ring_queue_spsc_pop(ring_queue_spsc* queue, void* out_value) {
+    u64 head = PE_ATOMIC_LOAD(&queue->head, PE_ATOMIC_RELAXED);
+    if (head == queue->cached_tail) {
+        queue->cached_tail = PE_ATOMIC_LOAD(&queue->tail, PE_ATOMIC_ACQUIRE);
+        if (head == queue->cached_tail) {
+            return false;
+        }
+    }
+
+    pe_copy_memory(out_value, element_at(queue->buffer, queue->element_size, head & queue->mask), queue->element_size);
+    // Hands the slot back to the producer
+    PE_ATOMIC_STORE(&queue->head, head + 1, PE_ATOMIC_RELEASE);
+    return true;
+}
+
+u64 ring_queue_spsc_length(const ring_queue_spsc* queue) {
+    u64 head = PE_ATOMIC_LOAD(&queue->head, PE_ATOMIC_ACQUIRE);
+    u64 tail = PE_ATOMIC_LOAD(&queue->tail, PE_ATOMIC_ACQUIRE);
+    return tail > head ? tail - head : 0;
+}
+
+// Multi producer, multi consumer
+//
+// A cell's sequence is its position when free for the push at that position, position + 1 once
+// filled for the pop at that position, and position + capacity once free for the push a lap later.
+// Threads claim a position by advancing the shared index with a compare exchange, then own the
+// cell until they publish its next sequence.
+
+PE_INLINE u64* cell_sequence(const ring_queue_mpmc* queue, u64 position) {
+    return (u64*)(queue->cells + (position & queue->mask) * queue->cell_size);
+}
+
+PE_INLINE u8* cell_element(const ring_queue_mpmc* queue, u64 position) {
+    return (u8*)(cell_sequence(queue, position) + 1);
+}
+
+b8 ring_queue_mpmc_create(u64 element_size, u64 capacity, ring_queue_mpmc* out_queue) {
+    if (!out_queue || element_size == 0) {
+        PE_ERROR("ring_queue_mpmc_create - requires an element size above 0 and a pointer to hold the queue.");
+        return false;
+    }
+
+    pe_zero_memory(out_queue, sizeof(ring_queue_mpmc));
+    out_queue->element_size = element_size;
+    out_queue->capacity = round_capacity(capacity);
+    out_queue->mask = out_queue->capacity - 1;
+    out_queue->cell_size = pe_align_up(sizeof(u64) + element_size, sizeof(u64));
+    out_queue->cells = allocate_buffer(out_queue->capacity * out_queue->cell_size);
+    if (!out_queue->cells) {
+        return false;
+    }
+
+    for (u64 i = 0; i < out_queue->capacity; ++i) {
+        *cell_sequence(out_queue, i) = i;
+    }
+    return true;
+}
+
+void ring_queue_mpmc_destroy(ring_queue_mpmc* queue) {
+    if (queue && queue->cells) {
+        free_buffer(queue->cells, queue->capacity * queue->cell_size);
+        pe_zero_memory(queue, sizeof(ring_queue_mpmc));
+    }
+}
+
+b8 ring_queue_mpmc_push(ring_queue_mpmc* queue, const void* value) {
+    u64 position = PE_ATOMIC_LOAD(&queue->enqueue_position, PE_ATOMIC_RELAXED);
+    for (;;) {
+        u64* sequence = cell_sequence(queue, position);
+        i64 difference = (i64)(PE_ATOMIC_LOAD(sequence, PE_ATOMIC_ACQUIRE) - position);
+        if (difference == 0) {
+            // Free for this position; claim it. On failure position is reloaded.
+            if (PE_ATOMIC_COMPARE_EXCHANGE_WEAK(&queue->enqueue_position, &position, position + 1, PE_ATOMIC_RELAXED, PE_ATOMIC_RELAXED)) {
+                pe_copy_memory(cell_element(queue, position), value, queue->element_size);
+                PE_ATOMIC_STORE(sequence, position + 1, PE_ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (difference < 0) {
+            // Still holds the element from a lap ago
+            return false;
+        } else {
+            // Another producer claimed it first
+            position = PE_ATOMIC_LOAD(&queue->enqueue_position, PE_ATOMIC_RELAXED);
+        }
+    }
+}
+
+b8 ring_queue_mpmc_pop(ring_queue_mpmc* queue, void* out_value) {
+    u64 position = PE_ATOMIC_LOAD(&queue->dequeue_position, PE_ATOMIC_RELAXED);
+    for (;;) {
+        u64* sequence = cell_sequence(queue, position);
+        i64 difference = (i64)(PE_ATOMIC_LOAD(sequence, PE_ATOMIC_ACQUIRE) - (position + 1));
+        if (difference == 0) {
+            if (PE_ATOMIC_COMPARE_EXCHANGE_WEAK(&queue->dequeue_position, &position, position + 1, PE_ATOMIC_RELAXED, PE_ATOMIC_RELAXED)) {
+                pe_copy_memory(out_value, cell_element(queue, position), queue->element_size);
+                PE_ATOMIC_STORE(sequence, position + queue->capacity, PE_ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (difference < 0) {
+            // Not filled yet
+            return false;
+        } else {
+            position = PE_ATOMIC_LOAD(&queue->dequeue_position, PE_ATOMIC_RELAXED);
+        }
+    }
+}
+
+u64 ring_queue_mpmc_length(const ring_queue_mpmc* queue) {
+    u64 dequeue = PE_ATOMIC_LOAD(&queue->dequeue_position, PE_ATOMIC_RELAXED);
+    u64 enqueue = PE_ATOMIC_LOAD(&queue->enqueue_position, PE_ATOMIC_RELAXED);
+    return enqueue > dequeue ? enqueue - dequeue : 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Fixed-capacity FIFO queues over a power-of-two ring buffer, holding fixed-size elements.
+
+ring_queue: single-threaded.
+ring_queue_spsc: one producer thread and one consumer thread. Wait-free.
+ring_queue_mpmc: any number of producer and consumer threads. Bounded, lock-free
+    (Dmitry Vyukov's design: each cell carries a sequence number telling whose turn it is).
+
+None of them take locks or allocate after creation; push fails when full and pop fails when empty.
+Indices written by different threads sit on their own cache lines, so queue structs should live
+on the stack, in static memory, or in blocks from pe_allocate_aligned(..., PE_CACHE_LINE_SIZE, ...).
+*/
+
+typedef struct ring_queue {
+    u64 element_size;
+    // Element count, a power of two
+    u64 capacity;
+    u64 mask;
+    u8* buffer;
+    // Next element to pop. Only ever increases; the slot is head & mask.
+    _Alignas(PE_CACHE_LINE_SIZE) u64 head;
+    // Next element to push
+    _Alignas(PE_CACHE_LINE_SIZE) u64 tail;
+} ring_queue;
+
+typedef struct ring_queue_spsc {
+    u64 element_size;
+    u64 capacity;
+    u64 mask;
+    u8* buffer;
+
+    // Producer side. cached_head is the producer's last view of head; it is only
+    // refreshed when the queue looks full, so most pushes touch no shared line but the slot.
+    _Alignas(PE_CACHE_LINE_SIZE) u64 tail;
+    u64 cached_head;
+
+    // Consumer side, likewise
+    _Alignas(PE_CACHE_LINE_SIZE) u64 head;
+    u64 cached_tail;
+} ring_queue_spsc;
+
+typedef struct ring_queue_mpmc {
+    u64 element_size;
+    u64 capacity;
+    u64 mask;
+    // Each cell is a u64 sequence followed by the element, cell_size bytes apart
+    u64 cell_size;
+    u8* cells;
+
+    _Alignas(PE_CACHE_LINE_SIZE) u64 enqueue_position;
+    _Alignas(PE_CACHE_LINE_SIZE) u64 dequeue_position;
+} ring_queue_mpmc;
+
+/**
+ * @brief Creates a single-threaded ring queue.
+ *
+ * @param element_size The size of each element in bytes
+ * @param capacity The number of elements the queue holds. Rounded up to a power of two, at least 2.
+ * @param out_queue A pointer to hold the queue
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 ring_queue_create(u64 element_size, u64 capacity, ring_queue* out_queue);
+PE_API void ring_queue_destroy(ring_queue* queue);
+// Copies value in at the back. Returns false if the queue is full.
+PE_API b8 ring_queue_push(ring_queue* queue, const void* value);
+// Copies the front element to out_value and removes it. Returns false if the queue is empty.
+PE_API b8 ring_queue_pop(ring_queue* queue, void* out_value);
+// Copies the front element to out_value without removing it. Returns false if the queue is empty.
+PE_API b8 ring_queue_peek(const ring_queue* queue, void* out_value);
+PE_API u64 ring_queue_length(const ring_queue* queue);
+
+// Creates a single producer, single consumer queue. Same parameters as ring_queue_create.
+PE_API b8 ring_queue_spsc_create(u64 element_size, u64 capacity, ring_queue_spsc* out_queue);
+// Not thread safe; no other thread may use the queue by now.
+PE_API void ring_queue_spsc_destroy(ring_queue_spsc* queue);
+// Producer thread only. Returns false if the queue is full.
+PE_API b8 ring_queue_spsc_push(ring_queue_spsc* queue, const void* value);
+// Consumer thread only. Returns false if the queue is empty.
+PE_API b8 ring_queue_spsc_pop(ring_queue_spsc* queue, void* out_value);
+// Approximate while either side is active.
+PE_API u64 ring_queue_spsc_length(const ring_queue_spsc* queue);
+
+// Creates a multi producer, multi consumer queue. Same parameters as ring_queue_create.
+PE_API b8 ring_queue_mpmc_create(u64 element_size, u64 capacity, ring_queue_mpmc* out_queue);
+// Not thread safe; no other thread may use the queue by now.
+PE_API void ring_queue_mpmc_destroy(ring_queue_mpmc* queue);
+// Any thread. Returns false if the queue is full.
+PE_API b8 ring_queue_mpmc_push(ring_queue_mpmc* queue, const void* value);
+// Any thread. Returns false if the queue is empty.
+PE_API b8 ring_queue_mpmc_pop(ring_queue_mpmc* queue, void* out_value);
+// Approximate while other threads are active.
+PE_API u64 ring_queue_mpmc_length(const ring_queue_mpmc* queue);
@@ -0,0 +1,158 @@
+#include "containers/slot_map.h"
+
+#include "core/pe_memory.h"
+#include "core/logger.h"
+
+// free_head when no used slot is free
+#define NO_FREE_SLOT 0xFFFFFFFFu
+
+#define MIN_CAPACITY 16
+
+PE_INLINE u8* value_at(const slot_map* map, u32 dense_index) {
+    return map->values + (u64)dense_index * map->element_size;
+}
+
+// Resizes a block, keeping its contents. Returns false, leaving it untouched, on failure.
+static b8 resize_array(void** block, u64 old_size, u64 new_size) {
+    void* resized = pe_reallocate(*block, old_size, new_size, MEMORY_TAG_SLOT_MAP);
+    if (!resized) {
+        return false;
+    }
+    *block = resized;
+    return true;
+}
+
+static b8 set_capacity(slot_map* map, u32 capacity) {
+    u32 old = map->capacity;
+    void** arrays[3] = {(void**)&map->slots, (void**)&map->dense_to_slot, (void**)&map->values};
+    const u64 strides[3] = {sizeof(slot_map_slot), sizeof(u32), map->element_size};
+    for (u32 i = 0; i < 3; ++i) {
+        if (resize_array(arrays[i], old * strides[i], capacity * strides[i])) {
+            continue;
+        }
+        PE_ERROR("slot_map - failed to grow to a capacity of %u.", capacity);
+        // Shrink the arrays that did grow back to map->capacity, which destroy frees them with
+        while (i-- > 0) {
+            if (old == 0) {
+                pe_free(*arrays[i], capacity * strides[i], MEMORY_TAG_SLOT_MAP);
+                *arrays[i] = 0;
+            } else {
+                resize_array(arrays[i], capacity * strides[i], old * strides[i]);
+            }
+        }
+        return false;
+    }
+    map->capacity = capacity;
+    return true;
+}
+
+b8 slot_map_create(u64 element_size, u32 capacity, slot_map* out_map) {
+    if (!out_map || element_size == 0) {
+        PE_ERROR("slot_map_create - requires an element size above 0 and a pointer to hold the map.");
+        return false;
+    }
+
+    pe_zero_memory(out_map, sizeof(slot_map));
+    out_map->element_size = element_size;
+    out_map->free_head = NO_FREE_SLOT;
+    return set_capacity(out_map, capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity);
+}
+
+void slot_map_destroy(slot_map* map) {
+    if (!map || !map->slots) {
+        return;
+    }
+
+    pe_free(map->slots, map->capacity * sizeof(slot_map_slot), MEMORY_TAG_SLOT_MAP);
+    pe_free(map->dense_to_slot, map->capacity * sizeof(u32), MEMORY_TAG_SLOT_MAP);
+    pe_free(map->values, map->capacity * map->element_size, MEMORY_TAG_SLOT_MAP);
+    pe_zero_memory(map, sizeof(slot_map));
+}
+
+b8 slot_map_reserve(slot_map* map, u32 capacity) {
+    if (capacity <= map->capacity) {
+        return true;
+    }
+    return set_capacity(map, capacity);
+}
+
+slot_map_handle slot_map_insert(slot_map* map, const void* value) {
+    if (map->count == map->capacity) {
+        u32 capacity = map->capacity * 2;
+        if (capacity < map->capacity || !set_capacity(map, capacity)) {
+            return SLOT_MAP_INVALID_HANDLE;
+        }
+    }
+
+    // Reuse a free slot before touching a new one
+    u32 index;
+    if (map->free_head != NO_FREE_SLOT) {
+        index = map->free_head;
+        map->free_head = map->slots[index].dense_index;
+    } else {
+        index = map->slot_count++;
+        map->slots[index].generation = 1;
+    }
+
+    slot_map_slot* slot = &map->slots[index];
+    u32 dense_index = map->count++;
+    slot->dense_index = dense_index;
+    map->dense_to_slot[dense_index] = index;
+    if (value) {
+        pe_copy_memory(value_at(map, dense_index), value, map->element_size);
+    } else {
+        pe_zero_memory(value_at(map, dense_index), map->element_size);
+    }
+
+    return (slot_map_handle){index, slot->generation};
+}
+
+// Retires a live slot: stales its handles and puts it on the free list
+static void free_slot(slot_map* map, u32 index) {
+    slot_map_slot* slot = &map->slots[index];
+    // 0 marks invalid handles, so skip it when wrapping around
+    slot->generation = slot->generation + 1 ? slot->generation + 1 : 1;
+    slot->dense_index = map->free_head;
+    map->free_head = index;
+}
+
+b8 slot_map_remove(slot_map* map, slot_map_handle handle) {
+    if (!slot_map_contains(map, handle)) {
+        return false;
+    }
+
+    // Fill the hole with the last value so values stay packed
+    u32 hole = map->slots[handle.index].dense_index;
+    u32 last = --map->count;
+    if (hole != last) {
+        pe_copy_memory(value_at(map, hole), value_at(map, last), map->element_size);
+        u32 moved_slot = map->dense_to_slot[last];
+        map->dense_to_slot[hole] = moved_slot;
+        map->slots[moved_slot].dense_index = hole;
+    }
+
+    free_slot(map, handle.index);
+    return true;
+}
+
+void* slot_map_get(const slot_map* map, slot_map_handle handle) {
+    if (!slot_map_contains(map, handle)) {
+        return 0;
+    }
+    return value_at(map, map->slots[handle.index].dense_index);
+}
+
+slot_map_handle slot_map_handle_at(const slot_map* map, u32 dense_index) {
+    if (dense_index >= map->count) {
+        return SLOT_MAP_INVALID_HANDLE;
+    }
+    u32 index = map->dense_to_slot[dense_index];
+    return (slot_map_handle){index, map->slots[index].generation};
+}
+
+void slot_map_clear(slot_map* map) {
+    for (u32 i = 0; i < map->count; ++i) {
+        free_slot(map, map->dense_to_slot[i]);
+    }
+    map->count = 0;
+}
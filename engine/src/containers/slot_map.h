@@ -0,0 +1,92 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Slot map: stores fixed-size values behind generational handles.
+
+Values are kept densely packed in values[0..count), so per-frame loops walk one contiguous
+array. Handles go through a slot, which records where its value currently sits in the dense
+array and a generation that changes each time the slot is freed. A handle whose generation
+no longer matches its slot's is stale, and lookups with it fail instead of reaching a value
+that has since moved or been replaced.
+
+Insert, remove and lookup are O(1). Removal moves the last value into the hole, so the
+order of values is not kept and pointers into values are only valid until the next change.
+*/
+
+// Refers to a value in a slot map. Copy freely; compare with slot_map_handles_equal.
+typedef struct slot_map_handle {
+    u32 index;
+    // Never 0 for a handle handed out by a slot map
+    u32 generation;
+} slot_map_handle;
+
+// Never valid; use to mark a handle as unset
+#define SLOT_MAP_INVALID_HANDLE ((slot_map_handle){0, 0})
+
+typedef struct slot_map_slot {
+    // Position of the slot's value in the dense array, or the next free slot while free
+    u32 dense_index;
+    u32 generation;
+} slot_map_slot;
+
+typedef struct slot_map {
+    u64 element_size;
+    // Live values, packed at the front of values
+    u32 count;
+    // Values and slots allocated
+    u32 capacity;
+    // Slots handed out at least once; the rest are untouched
+    u32 slot_count;
+    // First free slot, if any used slot is free
+    u32 free_head;
+    slot_map_slot* slots;
+    // Slot of each dense value, for fixing up the moved value on removal
+    u32* dense_to_slot;
+    u8* values;
+} slot_map;
+
+/**
+ * @brief Creates a slot map with room for capacity values before it has to grow.
+ *
+ * @param element_size The size of each value in bytes
+ * @param capacity The number of values to preallocate for
+ * @param out_map A pointer to hold the slot map
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 slot_map_create(u64 element_size, u32 capacity, slot_map* out_map);
+PE_API void slot_map_destroy(slot_map* map);
+
+// Grows the map so it holds capacity values without growing again. Never shrinks.
+PE_API b8 slot_map_reserve(slot_map* map, u32 capacity);
+
+/**
+ * @brief Adds a copy of value. Growing moves the values but keeps every handle valid.
+ *
+ * @param map The slot map
+ * @param value element_size bytes to store. 0 stores zeros.
+ * @returns A handle to the new value, or SLOT_MAP_INVALID_HANDLE on failure.
+ */
+PE_API slot_map_handle slot_map_insert(slot_map* map, const void* value);
+
+// Removes the value handle refers to. Returns false if the handle is stale.
+PE_API b8 slot_map_remove(slot_map* map, slot_map_handle handle);
+
+// Returns the value handle refers to, or 0 if the handle is stale. Valid until the map is next changed.
+PE_API void* slot_map_get(const slot_map* map, slot_map_handle handle);
+
+// Returns the handle of the value at dense_index in values, e.g. to remove it while iterating.
+PE_API slot_map_handle slot_map_handle_at(const slot_map* map, u32 dense_index);
+
+// Removes every value. All existing handles become stale.
+PE_API void slot_map_clear(slot_map* map);
+
+PE_INLINE b8 slot_map_contains(const slot_map* map, slot_map_handle handle) {
+    return handle.index < map->slot_count && map->slots[handle.index].generation == handle.generation &&
+           handle.generation != 0;
+}
+
+PE_INLINE b8 slot_map_handles_equal(slot_map_handle a, slot_map_handle b) {
+    return a.index == b.index && a.generation == b.generation;
+}
@@ -0,0 +1,104 @@
+#include "containers/sparse_set.h"
+
+#include "core/pe_memory.h"
+#include "core/logger.h"
+
+#define MIN_CAPACITY 16
+
+// Doubles capacity, with the arithmetic widened so it clamps at the u32 limit instead of wrapping
+static u32 doubled_capacity(u32 capacity) {
+    u64 doubled = (u64)capacity * 2;
+    return doubled > U32MAX ? U32MAX : (u32)doubled;
+}
+
+static b8 grow_dense(sparse_set* set, u32 capacity) {
+    u32* dense = pe_reallocate(set->dense, (u64)set->dense_capacity * sizeof(u32), (u64)capacity * sizeof(u32), MEMORY_TAG_ARRAY);
+    if (!dense) {
+        PE_ERROR("sparse_set - failed to grow to %u members.", capacity);
+        return false;
+    }
+    set->dense = dense;
+    set->dense_capacity = capacity;
+    return true;
+}
+
+static b8 grow_sparse(sparse_set* set, u32 capacity) {
+    u32* sparse = pe_reallocate(set->sparse, (u64)set->sparse_capacity * sizeof(u32), (u64)capacity * sizeof(u32), MEMORY_TAG_ARRAY);
+    if (!sparse) {
+        PE_ERROR("sparse_set - failed to grow to ids below %u.", capacity);
+        return false;
+    }
+    // Stale positions are harmless, but keep the new entries defined
+    pe_zero_memory(sparse + set->sparse_capacity, (u64)(capacity - set->sparse_capacity) * sizeof(u32));
+    set->sparse = sparse;
+    set->sparse_capacity = capacity;
+    return true;
+}
+
+b8 sparse_set_create(u32 max_id, u32 capacity, sparse_set* out_set) {
+    if (!out_set) {
+        PE_ERROR("sparse_set_create - requires a pointer to hold the set.");
+        return false;
+    }
+
+    if (max_id >= SPARSE_SET_ID_LIMIT) {
+        PE_ERROR("sparse_set_create - max_id must be below %u.", SPARSE_SET_ID_LIMIT);
+        return false;
+    }
+
+    pe_zero_memory(out_set, sizeof(sparse_set));
+    return grow_dense(out_set, capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity) &&
+           grow_sparse(out_set, max_id < MIN_CAPACITY ? MIN_CAPACITY : max_id + 1);
+}
+
+void sparse_set_destroy(sparse_set* set) {
+    if (!set) {
+        return;
+    }
+    if (set->dense) {
+        pe_free(set->dense, (u64)set->dense_capacity * sizeof(u32), MEMORY_TAG_ARRAY);
+    }
+    if (set->sparse) {
+        pe_free(set->sparse, (u64)set->sparse_capacity * sizeof(u32), MEMORY_TAG_ARRAY);
+    }
+    pe_zero_memory(set, sizeof(sparse_set));
+}
+
+b8 sparse_set_insert(sparse_set* set, u32 id) {
+    if (id >= SPARSE_SET_ID_LIMIT) {
+        PE_ERROR("sparse_set_insert - id must be below %u.", SPARSE_SET_ID_LIMIT);
+        return false;
+    }
+    if (sparse_set_contains(set, id)) {
+        return false;
+    }
+
+    if (id >= set->sparse_capacity) {
+        u32 capacity = doubled_capacity(set->sparse_capacity);
+        if (capacity <= id) {
+            capacity = id + 1;
+        }
+        if (!grow_sparse(set, capacity)) {
+            return false;
+        }
+    }
+    if (set->count == set->dense_capacity && !grow_dense(set, doubled_capacity(set->dense_capacity))) {
+        return false;
+    }
+
+    set->sparse[id] = set->count;
+    set->dense[set->count++] = id;
+    return true;
+}
+
+b8 sparse_set_remove(sparse_set* set, u32 id) {
+    if (!sparse_set_contains(set, id)) {
+        return false;
+    }
+
+    u32 position = set->sparse[id];
+    u32 last = set->dense[--set->count];
+    set->dense[position] = last;
+    set->sparse[last] = position;
+    return true;
+}
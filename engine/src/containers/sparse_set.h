@@ -0,0 +1,51 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Sparse set of u32 ids, such as entity ids.
+
+dense[0..count) lists the members packed together for iteration; sparse[id] holds the
+position of id in dense. An id is a member when that position is in range and dense
+points back at it, so membership, insert and remove are O(1), and clearing just resets
+count without touching sparse.
+*/
+
+// Ids must be below this, so the sparse array's size still fits in a u32
+#define SPARSE_SET_ID_LIMIT U32MAX
+
+typedef struct sparse_set {
+    u32 count;
+    u32 dense_capacity;
+    // Ids below this fit in sparse; larger ids grow it on insert
+    u32 sparse_capacity;
+    u32* dense;
+    u32* sparse;
+} sparse_set;
+
+/**
+ * @brief Creates an empty sparse set.
+ *
+ * @param max_id The largest id expected, to size the sparse array up front. Larger ids still work,
+ * up to SPARSE_SET_ID_LIMIT.
+ * @param capacity The number of members to preallocate for
+ * @param out_set A pointer to hold the set
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 sparse_set_create(u32 max_id, u32 capacity, sparse_set* out_set);
+PE_API void sparse_set_destroy(sparse_set* set);
+
+// Adds id. Returns true if it was added, false if it was already a member, not below
+// SPARSE_SET_ID_LIMIT, or growing failed.
+PE_API b8 sparse_set_insert(sparse_set* set, u32 id);
+
+// Removes id by moving the last member into its place. Returns false if id was not a member.
+PE_API b8 sparse_set_remove(sparse_set* set, u32 id);
+
+PE_INLINE b8 sparse_set_contains(const sparse_set* set, u32 id) {
+    return id < set->sparse_capacity && set->sparse[id] < set->count && set->dense[set->sparse[id]] == id;
+}
+
+PE_INLINE void sparse_set_clear(sparse_set* set) {
+    set->count = 0;
+}
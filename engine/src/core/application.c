@@ -4,15 +4,23 @@
 #include "logger.h"
 
 #include "platform/platform.h"
+#include "platform/filesystem.h"
+#include "platform/file_watcher.h"
 #include "core/pe_memory.h"
 #include "core/event.h"
 #include "core/input.h"
+#include "core/string_id.h"
 #include "core/clock.h"
+#include "core/frame_pacer.h"
 
 #include "memory/linear_allocator.h"
+#include "memory/frame_allocator.h"
 
 #include "renderer/renderer_frontend.h"
 
+// TODO: remove with the memory usage print below
+#include <stdlib.h>
+
 typedef struct application_state {
     game* game_inst;
     b8 is_running;
@@ -21,6 +29,7 @@ typedef struct application_state {
     i16 height;
     clock clock;
     f64 last_time;
+    frame_pacer frame_pacer;
     linear_allocator systems_allocator;
 
     u64 event_system_memory_requirement;
@@ -35,12 +44,24 @@ typedef struct application_state {
     u64 input_system_memory_requirement;
     void* input_system_state;
 
+    u64 string_id_system_memory_requirement;
+    void* string_id_system_state;
+
     u64 platform_system_memory_requirement;
     void* platform_system_state;
 
+    u64 filesystem_async_system_memory_requirement;
+    void* filesystem_async_system_state;
+
+    u64 file_watcher_system_memory_requirement;
+    void* file_watcher_system_state;
+
     u64 renderer_system_memory_requirement;
     void* renderer_system_state;
 
+    u64 frame_allocator_system_memory_requirement;
+    void* frame_allocator_system_state;
+
 } application_state;
 
 static application_state* app_state;
@@ -62,8 +83,13 @@ b8 application_create(game* game_inst) {
     app_state->is_running = false;
     app_state->is_suspended = false;
 
-    u64 systems_allocator_total_size = 64 * 1024 * 1024; // 64Mb
-    linear_allocator_create(systems_allocator_total_size, 0, &app_state->systems_allocator);
+    // Systems state is long-lived and touched every frame, so back it with huge pages when possible.
+    // Only reserved up front; memory is committed as subsystems claim it.
+    u64 systems_allocator_total_size = 1024 * 1024 * 1024; // 1Gb
+    if (!linear_allocator_create_virtual(systems_allocator_total_size, true, &app_state->systems_allocator)) {
+        PE_FATAL("Failed to reserve systems memory. Application cannot continue.");
+        return false;
+    }
 
     // Initialize subsystems
 
@@ -76,9 +102,20 @@ b8 application_create(game* game_inst) {
     }
 
     // Memory
-    memory_system_initialize(&app_state->memory_system_memory_requirement, 0);
-    app_state->memory_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->memory_system_memory_requirement);
-    memory_system_initialize(&app_state->memory_system_memory_requirement, app_state->memory_system_state);
+    memory_system_configuration memory_config;
+    pe_zero_memory(&memory_config, sizeof(memory_system_configuration));
+    memory_config.heap_size = 256 * 1024 * 1024; // 256Mb
+    memory_config.heap_tag_mask = MEMORY_TAG_MASK_ALL;
+    if (game_inst->app_config.memory_budgets) {
+        pe_copy_memory(memory_config.budgets, game_inst->app_config.memory_budgets, sizeof(memory_config.budgets));
+    }
+    memory_system_initialize(&app_state->memory_system_memory_requirement, 0, memory_config);
+    // Aligned, so each tag's counters sit on a cache line of their own
+    app_state->memory_system_state = linear_allocator_allocate_aligned(&app_state->systems_allocator, app_state->memory_system_memory_requirement, PE_CACHE_LINE_SIZE);
+    if (!memory_system_initialize(&app_state->memory_system_memory_requirement, app_state->memory_system_state, memory_config)) {
+        PE_ERROR("Memory system failed initialization. Application cannot continue.");
+        return false;
+    }
 
     // Logging
     logging_system_initialize(&app_state->logging_system_memory_requirement, 0);
@@ -93,6 +130,15 @@ b8 application_create(game* game_inst) {
     app_state->input_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->input_system_memory_requirement);
     input_system_initialize(&app_state->input_system_memory_requirement, app_state->input_system_state);
 
+    // String interning
+    u32 string_id_initial_capacity = 1024;
+    string_id_system_initialize(&app_state->string_id_system_memory_requirement, 0, 0);
+    app_state->string_id_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->string_id_system_memory_requirement);
+    if (!string_id_system_initialize(&app_state->string_id_system_memory_requirement, app_state->string_id_system_state, string_id_initial_capacity)) {
+        PE_FATAL("Failed to initialize string ID system. Aborting application.");
+        return false;
+    }
+
     // Register for engine-level events
     event_register(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
     event_register(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
@@ -113,6 +159,39 @@ b8 application_create(game* game_inst) {
         return false;
     }
 
+    platform_processor_info processor_info;
+    platform_get_processor_info(&processor_info);
+    PE_INFO("CPU: %u logical cores, %u physical cores, L1d %lluKiB, L2 %lluKiB, L3 %lluKiB, %uB cache lines.",
+        processor_info.logical_core_count,
+        processor_info.physical_core_count,
+        processor_info.l1_data_cache_size / 1024,
+        processor_info.l2_cache_size / 1024,
+        processor_info.l3_cache_size / 1024,
+        processor_info.cache_line_size);
+
+    // Async file I/O. Worker threads are only started when io_uring is unavailable.
+    u32 io_queue_depth = 256;
+    u32 io_worker_count = PE_CLAMP(processor_info.logical_core_count / 2, 1, 4);
+    filesystem_async_system_initialize(&app_state->filesystem_async_system_memory_requirement, 0, io_queue_depth, io_worker_count);
+    app_state->filesystem_async_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->filesystem_async_system_memory_requirement);
+    if (!filesystem_async_system_initialize(&app_state->filesystem_async_system_memory_requirement, app_state->filesystem_async_system_state, io_queue_depth, io_worker_count)) {
+        PE_ERROR("Failed to initialize async I/O system; shutting down.");
+        return false;
+    }
+
+    // File watcher
+    file_watcher_system_initialize(&app_state->file_watcher_system_memory_requirement, 0);
+    app_state->file_watcher_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->file_watcher_system_memory_requirement);
+    if (!file_watcher_system_initialize(&app_state->file_watcher_system_memory_requirement, app_state->file_watcher_system_state)) {
+        PE_ERROR("Failed to initialize file watcher system; shutting down.");
+        return false;
+    }
+#if defined(_DEBUG)
+    // Shader hot reload
+    u32 shader_watch_id;
+    file_watcher_watch_directory("assets/shaders", &shader_watch_id);
+#endif
+
     // Renderer startup
     renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0);
     app_state->renderer_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->renderer_system_memory_requirement);
@@ -121,6 +200,17 @@ b8 application_create(game* game_inst) {
         return false;
     }
 
+    // Frame scratch memory. One buffer more than the frames in flight, so the GPU is done
+    // with a frame's data by the time its buffer is reused.
+    u32 frame_buffer_count = PE_CLAMP(renderer_max_frames_in_flight() + 1, 2, FRAME_ALLOCATOR_MAX_BUFFERS);
+    u64 frame_buffer_size = 4 * 1024 * 1024; // 4Mb
+    frame_allocator_system_initialize(&app_state->frame_allocator_system_memory_requirement, 0, 0, 0);
+    app_state->frame_allocator_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->frame_allocator_system_memory_requirement);
+    if (!frame_allocator_system_initialize(&app_state->frame_allocator_system_memory_requirement, app_state->frame_allocator_system_state, frame_buffer_size, frame_buffer_count)) {
+        PE_FATAL("Failed to initialize frame allocator. Aborting application.");
+        return false;
+    }
+
     // Initialize the game
     if (!app_state->game_inst->initialize(app_state->game_inst)) {
         PE_FATAL("Game failed to initialize.");
@@ -140,9 +230,9 @@ b8 application_run() {
     app_state->last_time = app_state->clock.elapsed;
 
     f64 running_time = 0;
-    u8 frame_count = 0;
-    f64 target_frame_seconds = 1.0f / 60;
-
+    u64 frames_run = 0;
+    u64 max_frame_count = app_state->game_inst->app_config.max_frame_count;
+    frame_pacer_create(app_state->game_inst->app_config.target_frame_rate, &app_state->frame_pacer);
 
     // TODO: remove that
     char* memory_info = get_memory_usage_str();
@@ -161,6 +251,16 @@ b8 application_run() {
             f64 delta = (current_time - app_state->last_time);
             f64 frame_start_time = platform_get_absolute_time();
 
+            // Recycle the scratch memory of the oldest frame
+            frame_allocator_begin_frame();
+
+            // Report memory budgets crossed since the last frame
+            memory_system_update();
+
+            // Hand off I/O queued last frame, run completion callbacks and report changed files
+            filesystem_async_update();
+            file_watcher_update();
+
             if (!app_state->game_inst->update(app_state->game_inst, (f32)delta)) {
                 PE_FATAL("Game update failed, shutting down.");
                 app_state->is_running = false;
@@ -179,28 +279,40 @@ b8 application_run() {
             packet.delta_time = delta;
             renderer_draw_frame(&packet);
 
-            // Figure out how long the frame took and, if below
+            // Figure out how long the frame took, then wait out the rest of it
             f64 frame_end_time = platform_get_absolute_time();
             f64 frame_elapsed_time = frame_end_time - frame_start_time;
             running_time += frame_elapsed_time;
-            f64 remaining_seconds =target_frame_seconds - frame_elapsed_time;
+            frame_pacer_wait(&app_state->frame_pacer);
 
-            if (remaining_seconds > 0) {
-                u64 remaining_ms = (remaining_seconds * 1000);
+            input_update(delta);
 
-                // If there is time left, give it back to the OS
-                b8 limit_frames = false;
-                if (remaining_ms > 0 && limit_frames) {
-                    platform_sleep(remaining_ms - 1);
-                }
+            app_state->last_time = current_time;
 
-                frame_count++;
+            // Fixed-length runs stop after the requested number of frames
+            frames_run++;
+            if (max_frame_count && frames_run >= max_frame_count) {
+                app_state->is_running = false;
             }
+        }
+    }
 
-            input_update(delta);
+    if (frames_run > 0) {
+        PE_INFO(
+            "Ran %llu frames, CPU frame time: %.3f ms average.",
+            frames_run,
+            (running_time / frames_run) * 1000.0);
+    }
 
-            app_state->last_time = current_time;
-        }
+    PE_INFO("Frame allocator peak usage: %.2f KiB per frame.", frame_allocator_peak_usage() / 1024.0);
+
+    const frame_pacer_stats* pacing = &app_state->frame_pacer.stats;
+    if (app_state->frame_pacer.target_frame_seconds > 0 && pacing->frame_count > 0) {
+        PE_INFO(
+            "Frame pacing error: %.3f ms average, %.3f ms max, %llu missed frames.",
+            (pacing->error_total / pacing->frame_count) * 1000.0,
+            pacing->max_error * 1000.0,
+            pacing->missed_frame_count);
     }
 
     // If if exits loop without changing is_running
@@ -213,15 +325,26 @@ b8 application_run() {
 
     renderer_system_shutdown(app_state->renderer_system_state);
 
+    frame_allocator_system_shutdown(app_state->frame_allocator_system_state);
+
+    file_watcher_system_shutdown(app_state->file_watcher_system_state);
+
+    filesystem_async_system_shutdown(app_state->filesystem_async_system_state);
+
     platform_system_shutdown(app_state->platform_system_state);
+
+    string_id_system_shutdown(app_state->string_id_system_state);
     
     input_system_shutdown(app_state->input_system_state);
 
     logging_system_shutdown(app_state->logging_system_state);
 
+    event_system_shutdown(app_state->event_system_state);
+
+    // Last, as the systems above free their allocations into the engine heap
     memory_system_shutdown(app_state->memory_system_state);
 
-    event_system_shutdown(app_state->event_system_state);
+    linear_allocator_destroy(&app_state->systems_allocator);
 
     return true;
 }
@@ -292,6 +415,7 @@ b8 application_on_resized(u16 code, void* sender, void* listener_inst, event_con
                 if (app_state->is_suspended) {
                     PE_INFO("Window restored, resuming application.");
                     app_state->is_suspended = false;
+                    frame_pacer_reset(&app_state->frame_pacer);
                 }
                 app_state->game_inst->on_resize(app_state->game_inst, width, height);
                 renderer_on_resized(width, height);
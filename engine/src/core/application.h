@@ -3,6 +3,7 @@
 #include "defines.h"
 
 struct game;
+struct memory_tag_budget;
 
 // Application configuration
 typedef struct application_config {
@@ -20,6 +21,16 @@ typedef struct application_config {
 
     // The application name used in windowing, if applicable
     char* name;
+
+    // Number of frames to run before shutting down. 0 runs until a quit is requested.
+    // Used for deterministic benchmark runs, e.g. headless.
+    u64 max_frame_count;
+
+    // Frame rate to pace the main loop to. 0 runs unlimited (or as fast as vsync allows).
+    f32 target_frame_rate;
+
+    // Memory budgets, one per memory_tag (MEMORY_TAG_MAX_TAGS entries). 0 for no budgets.
+    const struct memory_tag_budget* memory_budgets;
 } application_config;
 
 PE_API b8 application_create(struct game* game_inst);
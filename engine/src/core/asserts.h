@@ -10,7 +10,7 @@
     #include <intrin.h>
     #define debugBreak() __debugbreak()
 #else
-    #define debugBreak() __builtint_trap()
+    #define debugBreak() __builtin_trap()
 #endif
 
 PE_API void report_assertion_failure(const char* expression, const char* message, const char* file, i32 line);
@@ -26,8 +26,8 @@ typedef struct event_context {
 // Should return true if handled
 typedef b8 (*PFN_on_event)(u16 code, void* sender, void* listener_inst, event_context data);
 
-b8 event_system_initialize(u64* memory_requirement, void* state);
-void event_system_shutdown(void* state);
+PE_API b8 event_system_initialize(u64* memory_requirement, void* state);
+PE_API void event_system_shutdown(void* state);
 
 /**
  * Register to listen for when events are sent with the provided code. Events with duplicate
@@ -107,6 +107,21 @@ typedef enum system_event_code {
      * u16 height = data.data.u16[1];
      */
     EVENT_CODE_RESIZED = 0x08,
+
+    // A file in a watched directory was written, created or renamed into place.
+    /* Context usage:
+     * u32 watch_id = data.data.u32[0];
+     * const char* file_name = (const char*)data.data.u64[1]; // only valid during the event
+     */
+    EVENT_CODE_FILE_CHANGED = 0x09,
+
+    // An allocation took a memory tag past its soft budget. Fired on the main thread by
+    // memory_system_update, at the start of the frame after the crossing.
+    /* Context usage:
+     * memory_tag tag = (memory_tag)data.data.u32[0];
+     * u64 allocated = data.data.u64[1]; // bytes allocated under the tag, including the crossing allocation
+     */
+    EVENT_CODE_MEMORY_BUDGET_EXCEEDED = 0x0A,
     
     MAX_EVENT_CODE = 0xFF
 } system_event_code;
\ No newline at end of file
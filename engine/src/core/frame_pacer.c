@@ -0,0 +1,113 @@
+#include "frame_pacer.h"
+
+#include "platform/platform.h"
+#include "math/pe_math.h"
+
+// Length of a single sleep slice. Short slices keep the error of a single overshoot small.
+#define SLEEP_SLICE_MICROSECONDS 1000
+#define SLEEP_SLICE_SECONDS (SLEEP_SLICE_MICROSECONDS / 1000000.0)
+
+// Weight of the newest sample in the overshoot moving averages
+#define OVERSHOOT_SMOOTHING 0.1
+
+#define CALIBRATION_SLEEP_COUNT 5
+
+static void overshoot_record(frame_pacer* pacer, f64 overshoot) {
+    f64 delta = overshoot - pacer->overshoot_mean;
+    pacer->overshoot_mean += OVERSHOOT_SMOOTHING * delta;
+    pacer->overshoot_variance = (1.0 - OVERSHOOT_SMOOTHING) * (pacer->overshoot_variance + OVERSHOOT_SMOOTHING * delta * delta);
+
+    // Cover most outliers; a late wakeup costs a missed deadline, an early one only a bit more spinning
+    pacer->overshoot_estimate = pacer->overshoot_mean + 2.0 * pe_sqrt((f32)pacer->overshoot_variance);
+    if (pacer->overshoot_estimate < 0) {
+        pacer->overshoot_estimate = 0;
+    }
+}
+
+// Sleeps for one slice and records how much longer than asked the OS took.
+static f64 sleep_slice(frame_pacer* pacer) {
+    f64 start = platform_get_absolute_time();
+    platform_sleep_microseconds(SLEEP_SLICE_MICROSECONDS);
+    f64 end = platform_get_absolute_time();
+    overshoot_record(pacer, (end - start) - SLEEP_SLICE_SECONDS);
+    return end;
+}
+
+void frame_pacer_create(f64 target_frame_rate, frame_pacer* out_pacer) {
+    out_pacer->next_deadline = 0;
+    out_pacer->overshoot_mean = 0;
+    out_pacer->overshoot_variance = 0;
+    out_pacer->overshoot_estimate = 0;
+    out_pacer->stats.frame_count = 0;
+    out_pacer->stats.missed_frame_count = 0;
+    out_pacer->stats.last_error = 0;
+    out_pacer->stats.max_error = 0;
+    out_pacer->stats.error_total = 0;
+    frame_pacer_set_target_rate(out_pacer, target_frame_rate);
+
+    // Seed the averages with a few samples. The first one is taken as the mean outright,
+    // so the estimate doesn't start out biased towards 0.
+    f64 start = platform_get_absolute_time();
+    platform_sleep_microseconds(SLEEP_SLICE_MICROSECONDS);
+    f64 first_overshoot = (platform_get_absolute_time() - start) - SLEEP_SLICE_SECONDS;
+    out_pacer->overshoot_mean = first_overshoot;
+    overshoot_record(out_pacer, first_overshoot);
+    for (u32 i = 1; i < CALIBRATION_SLEEP_COUNT; ++i) {
+        sleep_slice(out_pacer);
+    }
+}
+
+void frame_pacer_set_target_rate(frame_pacer* pacer, f64 target_frame_rate) {
+    pacer->target_frame_seconds = target_frame_rate > 0 ? 1.0 / target_frame_rate : 0;
+    pacer->next_deadline = 0;
+}
+
+void frame_pacer_reset(frame_pacer* pacer) {
+    pacer->next_deadline = 0;
+}
+
+f64 frame_pacer_wait(frame_pacer* pacer) {
+    f64 now = platform_get_absolute_time();
+    pacer->stats.frame_count++;
+
+    if (pacer->target_frame_seconds <= 0) {
+        pacer->stats.last_error = 0;
+        return 0;
+    }
+
+    if (pacer->next_deadline == 0) {
+        // First frame of the schedule; nothing to compare against yet
+        pacer->next_deadline = now + pacer->target_frame_seconds;
+        pacer->stats.last_error = 0;
+        return 0;
+    }
+
+    // Sleep while even a late wakeup would still land before the deadline
+    while (pacer->next_deadline - now > SLEEP_SLICE_SECONDS + pacer->overshoot_estimate) {
+        now = sleep_slice(pacer);
+    }
+
+    // Spin out the remainder
+    while (now < pacer->next_deadline) {
+        PE_CPU_PAUSE();
+        now = platform_get_absolute_time();
+    }
+
+    f64 error = now - pacer->next_deadline;
+    pacer->stats.last_error = error;
+    pacer->stats.error_total += error;
+    if (error > pacer->stats.max_error) {
+        pacer->stats.max_error = error;
+    }
+
+    if (error >= pacer->target_frame_seconds) {
+        // Too far behind to catch up without a burst of short frames; restart from now
+        pacer->stats.missed_frame_count++;
+        pacer->next_deadline = now + pacer->target_frame_seconds;
+    } else {
+        // Schedule from the deadline rather than from now, so errors don't accumulate into drift
+        pacer->next_deadline += pacer->target_frame_seconds;
+    }
+
+    return error;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "defines.h"
+
+typedef struct frame_pacer_stats {
+    u64 frame_count;
+    // Frames that ended a whole frame or more past their deadline; the schedule restarts after those
+    u64 missed_frame_count;
+    // How far past its deadline the last frame ended, in seconds. Only ever late, spinning
+    // makes early wakeups impossible.
+    f64 last_error;
+    f64 max_error;
+    f64 error_total;
+} frame_pacer_stats;
+
+// Paces frames to a target rate. Waits by sleeping in short slices while the deadline is further
+// away than the OS is likely to overshoot a sleep by, then spins for the rest. The overshoot is
+// measured on every sleep, so the spin stays as short as the platform allows.
+typedef struct frame_pacer {
+    // 0 if frames aren't limited
+    f64 target_frame_seconds;
+    // Absolute time the current frame should end at. 0 until the first frame.
+    f64 next_deadline;
+
+    // Observed sleep overshoot, as an exponential moving mean and variance, in seconds
+    f64 overshoot_mean;
+    f64 overshoot_variance;
+    // Remaining time below which sleeping is no longer safe
+    f64 overshoot_estimate;
+
+    frame_pacer_stats stats;
+} frame_pacer;
+
+// Creates a pacer for the given frame rate (0 for unlimited) and calibrates the sleep overshoot.
+// Calibration sleeps for a few milliseconds.
+PE_API void frame_pacer_create(f64 target_frame_rate, frame_pacer* out_pacer);
+
+// Changes the target frame rate. 0 turns limiting off.
+PE_API void frame_pacer_set_target_rate(frame_pacer* pacer, f64 target_frame_rate);
+
+// Restarts the schedule from the next frame, e.g. after being suspended. Does not reset stats.
+PE_API void frame_pacer_reset(frame_pacer* pacer);
+
+// Blocks until the end of the current frame. Call once per frame, after all of its work.
+// Returns the pacing error of the frame in seconds.
+PE_API f64 frame_pacer_wait(frame_pacer* pacer);
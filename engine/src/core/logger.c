@@ -15,7 +15,7 @@ typedef struct logger_system_state {
 
 static logger_system_state* state_ptr;
 
-void append_to_log_file(const char* message) {
+void append_to_log_file(const char* message, b8 flush) {
     // TODO: why is_valid state of file_handle changes?
     if (state_ptr && state_ptr->log_file_handle.handle) {
     //if (state_ptr && state_ptr->log_file_handle.is_valid) {
@@ -26,6 +26,11 @@ void append_to_log_file(const char* message) {
         if (!filesystem_write(&state_ptr->log_file_handle, length, message, &written)) {
             platform_console_write_error("[ERROR]: writing to console.log.", LOG_LEVEL_ERROR);
         }
+
+        // Writes are buffered; only errors are pushed out right away so they survive a crash
+        if (flush) {
+            filesystem_flush(&state_ptr->log_file_handle);
+        }
     }
 }
 
@@ -91,7 +96,7 @@ void log_output(log_level level, const char* message, ...){
     }
 
     // Queue a copy to be written to the log file
-    append_to_log_file(out_message);
+    append_to_log_file(out_message, is_error);
 }
 
 void report_assertion_failure(const char* expression, const char* message, const char* file, i32 line){
@@ -1,15 +1,30 @@
 #include "pe_memory.h"
 
 #include "core/logger.h"
+#include "core/event.h"
+#include "memory/dynamic_allocator.h"
+#include "memory/pool_allocator.h"
 #include "platform/platform.h"
 
 // TODO: Custom string lib
 #include <string.h>
 #include <stdio.h>
 
+// Counters for one tag, updated with relaxed atomics from any thread. Aligned to a cache line
+// so threads allocating under different tags don't contend. Totals are summed when read.
+typedef struct tag_counters {
+    _Alignas(PE_CACHE_LINE_SIZE) u64 allocated;
+    u64 peak;
+    u64 allocation_count;
+    u64 free_count;
+    // Bytes allocated when the tag last crossed its soft limit; 0 once memory_system_update has reported it
+    u64 soft_limit_crossed_bytes;
+} tag_counters;
+
+STATIC_ASSERT(sizeof(tag_counters) == PE_CACHE_LINE_SIZE, "Expected tag_counters to fill exactly one cache line.");
+
 struct memory_stats {
-    u64 total_allocated;
-    u64 tagged_allocations[MEMORY_TAG_MAX_TAGS];
+    tag_counters tags[MEMORY_TAG_MAX_TAGS];
 };
 
 static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
@@ -20,6 +35,7 @@ static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
     "DICT       ",
     "RING_QUEUE ",
     "BST        ",
+    "SLOT_MAP   ",
     "STRING     ",
     "APPLICATION",
     "JOB        ",
@@ -30,47 +46,244 @@ static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
     "TRANSFORM  ",
     "ENTITY     ",
     "ENTITY_NODE",
-    "SCENE      "
+    "SCENE      ",
+    "VK_COMMAND ",
+    "VK_OBJECT  ",
+    "VK_CACHE   ",
+    "VK_DEVICE  ",
+    "VK_INSTANCE"
 };
 
+// Pools beyond this still work, they just aren't listed in the usage stats
+#define MAX_REGISTERED_POOLS 32
+
 typedef struct memory_system_state {
+    memory_system_configuration config;
     struct memory_stats stats;
-    u64 alloc_count;
+    // Reserved range holding the heap allocator's state followed by the heap itself
+    void* heap_memory;
+    u64 heap_memory_size;
+    dynamic_allocator heap;
+    // The heap is shared by every thread that allocates
+    platform_mutex heap_mutex;
+    pool_allocator* pools[MAX_REGISTERED_POOLS];
 } memory_system_state;
 
 static memory_system_state* state_ptr;
 
-b8 memory_system_initialize(u64* memory_requirement, void* state) {
+b8 memory_system_initialize(u64* memory_requirement, void* state, memory_system_configuration config) {
     *memory_requirement = sizeof(memory_system_state);
     if (state == 0) {
         return false;
     }
 
+    if ((u64)state % PE_CACHE_LINE_SIZE != 0) {
+        PE_FATAL("Memory system state must be aligned to %u bytes.", PE_CACHE_LINE_SIZE);
+        return false;
+    }
+
     state_ptr = state;
-    state_ptr->alloc_count = 0;
-    platform_zero_memory(&state_ptr->stats, sizeof(state_ptr->stats));
+    platform_zero_memory(state_ptr, sizeof(memory_system_state));
+    state_ptr->config = config;
+
+    if (config.heap_size == 0 || config.heap_tag_mask == 0) {
+        // Everything goes to the C runtime heap
+        state_ptr->config.heap_tag_mask = 0;
+        return true;
+    }
+
+    u64 heap_requirement = 0;
+    if (!dynamic_allocator_create(config.heap_size, &heap_requirement, 0, 0)) {
+        PE_FATAL("Unable to size the engine heap.");
+        return false;
+    }
+
+    // Committed up front; the OS still only backs pages with memory once they are touched
+    state_ptr->heap_memory_size = pe_align_up(heap_requirement, platform_get_page_size());
+    state_ptr->heap_memory = platform_memory_reserve(state_ptr->heap_memory_size, PLATFORM_MEMORY_FLAG_HUGE_PAGES);
+    if (!state_ptr->heap_memory || !platform_memory_commit(state_ptr->heap_memory, state_ptr->heap_memory_size, PLATFORM_MEMORY_FLAG_HUGE_PAGES)) {
+        PE_FATAL("Unable to reserve %lluB for the engine heap.", state_ptr->heap_memory_size);
+        if (state_ptr->heap_memory) {
+            platform_memory_release(state_ptr->heap_memory, state_ptr->heap_memory_size);
+        }
+        return false;
+    }
+
+    if (!dynamic_allocator_create(config.heap_size, &heap_requirement, state_ptr->heap_memory, &state_ptr->heap) ||
+        !platform_mutex_create(&state_ptr->heap_mutex)) {
+        PE_FATAL("Unable to create the engine heap.");
+        platform_memory_release(state_ptr->heap_memory, state_ptr->heap_memory_size);
+        return false;
+    }
 
     return true;
 }
 
 void memory_system_shutdown(void* state) {
+    if (state_ptr && state_ptr->heap_memory) {
+        dynamic_allocator_destroy(&state_ptr->heap);
+        platform_mutex_destroy(&state_ptr->heap_mutex);
+        platform_memory_release(state_ptr->heap_memory, state_ptr->heap_memory_size);
+    }
     state_ptr = 0;
 }
 
+// Adds size bytes to a tag. Fails, adding nothing, if it would take the tag past its hard limit.
+// The check and the add happen in one compare-exchange, so a thread is only refused when the
+// bytes really allocated leave no room for it, however many threads allocate at once.
+static b8 stats_add_bytes(memory_tag tag, u64 size) {
+    tag_counters* counters = &state_ptr->stats.tags[tag];
+    const memory_tag_budget* budget = &state_ptr->config.budgets[tag];
+    u64 previous = PE_ATOMIC_LOAD(&counters->allocated, PE_ATOMIC_RELAXED);
+    u64 allocated;
+    do {
+        allocated = previous + size;
+        if (budget->hard_limit && allocated > budget->hard_limit) {
+            PE_ERROR("Allocation of %lluB for tag %s refused; it would exceed the tag's hard limit of %lluB.", size, memory_tag_strings[tag], budget->hard_limit);
+            return false;
+        }
+    } while (!PE_ATOMIC_COMPARE_EXCHANGE_WEAK(&counters->allocated, &previous, allocated, PE_ATOMIC_RELAXED, PE_ATOMIC_RELAXED));
+
+    // Usually below the peak already, in which case this is just a load
+    u64 peak = PE_ATOMIC_LOAD(&counters->peak, PE_ATOMIC_RELAXED);
+    while (allocated > peak &&
+           !PE_ATOMIC_COMPARE_EXCHANGE_WEAK(&counters->peak, &peak, allocated, PE_ATOMIC_RELAXED, PE_ATOMIC_RELAXED)) {
+    }
+
+    // Only the allocation that crosses the limit flags it. The event system isn't thread-safe,
+    // so the event itself is fired later by memory_system_update, on the main thread.
+    if (budget->soft_limit && allocated > budget->soft_limit && previous <= budget->soft_limit) {
+        PE_ATOMIC_STORE(&counters->soft_limit_crossed_bytes, allocated, PE_ATOMIC_RELAXED);
+    }
+
+    return true;
+}
+
+void memory_system_update() {
+    if (!state_ptr) {
+        return;
+    }
+
+    for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        u64 crossed_bytes = PE_ATOMIC_EXCHANGE(&state_ptr->stats.tags[i].soft_limit_crossed_bytes, 0, PE_ATOMIC_RELAXED);
+        if (crossed_bytes) {
+            PE_WARN("Tag %s is over its soft limit: %lluB allocated, limit %lluB.", memory_tag_strings[i], crossed_bytes, state_ptr->config.budgets[i].soft_limit);
+            event_context context;
+            context.data.u32[0] = i;
+            context.data.u64[1] = crossed_bytes;
+            event_fire(EVENT_CODE_MEMORY_BUDGET_EXCEEDED, 0, context);
+        }
+    }
+}
+
+// Accounts for an allocation about to be made. Fails, accounting nothing, if it would take the tag
+// past its hard limit.
+static b8 stats_record_allocation(memory_tag tag, u64 size) {
+    if (!state_ptr) {
+        return true;
+    }
+
+    if (!stats_add_bytes(tag, size)) {
+        return false;
+    }
+    PE_ATOMIC_FETCH_ADD(&state_ptr->stats.tags[tag].allocation_count, 1, PE_ATOMIC_RELAXED);
+    return true;
+}
+
+static void stats_remove_bytes(memory_tag tag, u64 size) {
+    PE_ATOMIC_FETCH_SUB(&state_ptr->stats.tags[tag].allocated, size, PE_ATOMIC_RELAXED);
+}
+
+// Accounts for a block changing size. Counts neither an allocation nor a free.
+static b8 stats_record_resize(memory_tag tag, u64 old_size, u64 new_size) {
+    if (!state_ptr) {
+        return true;
+    }
+
+    if (new_size > old_size) {
+        return stats_add_bytes(tag, new_size - old_size);
+    }
+    stats_remove_bytes(tag, old_size - new_size);
+    return true;
+}
+
+// Undoes stats_record_allocation when the allocation itself failed
+static void stats_cancel_allocation(memory_tag tag, u64 size) {
+    if (!state_ptr) {
+        return;
+    }
+
+    PE_ATOMIC_FETCH_SUB(&state_ptr->stats.tags[tag].allocation_count, 1, PE_ATOMIC_RELAXED);
+    stats_remove_bytes(tag, size);
+}
+
+static void stats_record_free(memory_tag tag, u64 size) {
+    if (!state_ptr) {
+        return;
+    }
+
+    PE_ATOMIC_FETCH_ADD(&state_ptr->stats.tags[tag].free_count, 1, PE_ATOMIC_RELAXED);
+    stats_remove_bytes(tag, size);
+}
+
+PE_INLINE b8 heap_serves_tag(memory_tag tag) {
+    return state_ptr && (state_ptr->config.heap_tag_mask & MEMORY_TAG_BIT(tag));
+}
+
+// Allocates from the engine heap. Alignment of 0 means the heap's natural 16 byte alignment.
+static void* heap_allocate(u64 size, u16 alignment, memory_tag tag) {
+    platform_mutex_lock(&state_ptr->heap_mutex);
+    void* block = alignment ? dynamic_allocator_allocate_aligned(&state_ptr->heap, size, alignment)
+                            : dynamic_allocator_allocate(&state_ptr->heap, size);
+    platform_mutex_unlock(&state_ptr->heap_mutex);
+
+    if (!block) {
+        PE_ERROR("Engine heap exhausted allocating %lluB for tag %s; raise memory_system_configuration.heap_size.", size, memory_tag_strings[tag]);
+    }
+    return block;
+}
+
+// Frees a block from the engine heap. Returns false for blocks that came from elsewhere,
+// such as allocations made before the memory system started or with tags outside the heap.
+static b8 heap_free(void* block) {
+    if (!state_ptr || !dynamic_allocator_owns(&state_ptr->heap, block)) {
+        return false;
+    }
+
+    platform_mutex_lock(&state_ptr->heap_mutex);
+    dynamic_allocator_free(&state_ptr->heap, block);
+    platform_mutex_unlock(&state_ptr->heap_mutex);
+    return true;
+}
+
 void* pe_allocate(u64 size, memory_tag tag) {
+    void* block = pe_allocate_uninit(size, tag);
+    if (block) {
+        platform_zero_memory(block, size);
+    }
+    return block;
+}
+
+void* pe_allocate_uninit(u64 size, memory_tag tag) {
     if (tag == MEMORY_TAG_UNKNOWN) {
         PE_WARN("pe_allocate called using MEMORY_TAG_UNKNOWN. Re-clsss this allocatoin.");
     }
 
-    if (state_ptr){
-        state_ptr->stats.total_allocated += size;
-        state_ptr->stats.tagged_allocations[tag] += size;
-        state_ptr->alloc_count++;
+    if (!stats_record_allocation(tag, size)) {
+        return 0;
     }
 
-    // TODO: Memory alignment
-    void* block = platform_allocate(size, false);
-    platform_zero_memory(block, size);
+    void* block = 0;
+    if (heap_serves_tag(tag)) {
+        block = heap_allocate(size, 0, tag);
+        if (!block) {
+            stats_cancel_allocation(tag, size);
+            return 0;
+        }
+    } else {
+        // malloc already aligns for any fundamental type; use pe_allocate_aligned for more
+        block = platform_allocate(size, false);
+    }
 
     return block;
 }
@@ -80,13 +293,225 @@ void pe_free(void* block, u64 size, memory_tag tag) {
         PE_WARN("pe_free called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
     }
 
+    stats_record_free(tag, size);
+
+    if (!heap_free(block)) {
+        platform_free(block, false);
+    }
+}
+
+void* pe_reallocate(void* block, u64 old_size, u64 new_size, memory_tag tag) {
+    if (!block) {
+        return pe_allocate_uninit(new_size, tag);
+    }
+    if (tag == MEMORY_TAG_UNKNOWN) {
+        PE_WARN("pe_reallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+    }
+
+    if (!stats_record_resize(tag, old_size, new_size)) {
+        return 0;
+    }
+
+    if (state_ptr && dynamic_allocator_owns(&state_ptr->heap, block)) {
+        platform_mutex_lock(&state_ptr->heap_mutex);
+        b8 resized = dynamic_allocator_resize(&state_ptr->heap, block, new_size);
+        platform_mutex_unlock(&state_ptr->heap_mutex);
+        if (resized) {
+            return block;
+        }
+
+        // No room behind the block; move it
+        void* moved = heap_allocate(new_size, 0, tag);
+        if (!moved) {
+            stats_record_resize(tag, new_size, old_size);
+            return 0;
+        }
+        platform_copy_memory(moved, block, old_size < new_size ? old_size : new_size);
+        heap_free(block);
+        return moved;
+    }
+
+    // Allocated by the C runtime, either for a tag outside the heap or before the memory system started
+    void* moved = platform_reallocate(block, new_size);
+    if (!moved) {
+        stats_record_resize(tag, new_size, old_size);
+    }
+    return moved;
+}
+
+// Stored just in front of every aligned block
+typedef struct aligned_block_header {
+    // Distance from the start of the underlying allocation to the aligned block
+    u64 offset;
+} aligned_block_header;
+
+static u64 aligned_total_size(u64 size, u16 alignment) {
+    // Worst case padding, plus room for the header in front of the block
+    return size + alignment - 1 + sizeof(aligned_block_header);
+}
+
+void* pe_allocate_aligned(u64 size, u16 alignment, memory_tag tag) {
+    void* block = pe_allocate_aligned_uninit(size, alignment, tag);
+    if (block) {
+        platform_zero_memory(block, size);
+    }
+    return block;
+}
+
+void* pe_allocate_aligned_uninit(u64 size, u16 alignment, memory_tag tag) {
+    if (tag == MEMORY_TAG_UNKNOWN) {
+        PE_WARN("pe_allocate_aligned called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+    }
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        PE_ERROR("pe_allocate_aligned - alignment %u is not a power of two.", alignment);
+        return 0;
+    }
+
+    u64 total_size = aligned_total_size(size, alignment);
+    if (!stats_record_allocation(tag, total_size)) {
+        return 0;
+    }
+
+    u8* block = 0;
+    if (heap_serves_tag(tag)) {
+        // The heap keeps its own record of the padding
+        block = heap_allocate(size, alignment, tag);
+        if (!block) {
+            stats_cancel_allocation(tag, total_size);
+            return 0;
+        }
+    } else {
+        u8* raw = platform_allocate(total_size, true);
+        if (!raw) {
+            stats_cancel_allocation(tag, total_size);
+            return 0;
+        }
+        block = (u8*)pe_align_up((u64)(raw + sizeof(aligned_block_header)), alignment);
+        aligned_block_header* header = (aligned_block_header*)(block - sizeof(aligned_block_header));
+        header->offset = (u64)(block - raw);
+    }
+
+    return block;
+}
+
+void pe_free_aligned(void* block, u64 size, u16 alignment, memory_tag tag) {
+    if (tag == MEMORY_TAG_UNKNOWN) {
+        PE_WARN("pe_free_aligned called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+    }
+    if (!block) {
+        return;
+    }
+
+    u64 total_size = aligned_total_size(size, alignment);
+    stats_record_free(tag, total_size);
+
+    if (heap_free(block)) {
+        return;
+    }
+
+    aligned_block_header* header = (aligned_block_header*)((u8*)block - sizeof(aligned_block_header));
+    platform_free((u8*)block - header->offset, true);
+}
+
+u64 pe_memory_page_size() {
+    return platform_get_page_size();
+}
+
+u64 pe_memory_huge_page_size() {
+    u64 size = platform_get_huge_page_size();
+    return size ? size : platform_get_page_size();
+}
+
+void* pe_memory_reserve(u64 size, b8 huge_pages) {
+    return platform_memory_reserve(size, huge_pages ? PLATFORM_MEMORY_FLAG_HUGE_PAGES : PLATFORM_MEMORY_FLAG_NONE);
+}
+
+b8 pe_memory_commit(void* address, u64 size, b8 huge_pages, memory_tag tag) {
+    if (tag == MEMORY_TAG_UNKNOWN) {
+        PE_WARN("pe_memory_commit called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+    }
+
+    // Commits grow an existing reservation, so they count towards the tag's bytes but not
+    // as allocations of their own
+    if (state_ptr && !stats_add_bytes(tag, size)) {
+        return false;
+    }
+
+    if (!platform_memory_commit(address, size, huge_pages ? PLATFORM_MEMORY_FLAG_HUGE_PAGES : PLATFORM_MEMORY_FLAG_NONE)) {
+        PE_ERROR("pe_memory_commit - failed to commit %lluB.", size);
+        if (state_ptr) {
+            stats_remove_bytes(tag, size);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void pe_memory_decommit(void* address, u64 size, memory_tag tag) {
     if (state_ptr) {
-        state_ptr->stats.total_allocated -= size;
-        state_ptr->stats.tagged_allocations[tag] -= size;
+        stats_remove_bytes(tag, size);
+    }
+    platform_memory_decommit(address, size);
+}
+
+void pe_memory_release(void* address, u64 size) {
+    platform_memory_release(address, size);
+}
+
+static u64 pages_size_round(u64 size, b8 huge_pages) {
+    u64 granularity = huge_pages ? platform_get_huge_page_size() : 0;
+    if (!granularity) {
+        granularity = platform_get_page_size();
+    }
+    return (size + granularity - 1) & ~(granularity - 1);
+}
+
+void* pe_allocate_pages(u64 size, b8 huge_pages, memory_tag tag) {
+    u64 rounded_size = pages_size_round(size, huge_pages);
+    if (!stats_record_allocation(tag, rounded_size)) {
+        return 0;
+    }
+
+    void* block = 0;
+    u32 flags = PLATFORM_MEMORY_FLAG_NONE;
+
+    if (huge_pages) {
+        // Explicit huge pages need pages set aside by the OS, so this fails on most default setups
+        flags = PLATFORM_MEMORY_FLAG_EXPLICIT_HUGE_PAGES;
+        block = platform_memory_reserve(rounded_size, flags);
+        if (!block) {
+            PE_DEBUG("pe_allocate_pages - explicit huge pages unavailable, falling back to transparent huge pages.");
+            flags = PLATFORM_MEMORY_FLAG_HUGE_PAGES;
+            block = platform_memory_reserve(rounded_size, flags);
+        }
+    } else {
+        block = platform_memory_reserve(rounded_size, flags);
+    }
+
+    if (!block) {
+        PE_ERROR("pe_allocate_pages - failed to reserve %lluB.", rounded_size);
+        stats_cancel_allocation(tag, rounded_size);
+        return 0;
     }
 
-    // TODO: Memory alignment
-    platform_free(block, false);
+    if (!platform_memory_commit(block, rounded_size, flags)) {
+        PE_ERROR("pe_allocate_pages - failed to commit %lluB.", rounded_size);
+        platform_memory_release(block, rounded_size);
+        stats_cancel_allocation(tag, rounded_size);
+        return 0;
+    }
+
+    // Fresh pages are already zeroed by the OS
+    return block;
+}
+
+void pe_free_pages(void* block, u64 size, b8 huge_pages, memory_tag tag) {
+    u64 rounded_size = pages_size_round(size, huge_pages);
+
+    stats_record_free(tag, rounded_size);
+
+    platform_memory_release(block, rounded_size);
 }
 
 void* pe_zero_memory(void* block, u64 size) {
@@ -97,48 +522,134 @@ void* pe_copy_memory(void* dst, const void* src, u64 size) {
     return platform_copy_memory(dst, src, size);
 }
 
+void* pe_move_memory(void* dst, const void* src, u64 size) {
+    return platform_move_memory(dst, src, size);
+}
+
 void* pe_set_memory(void* dst, i32 value, u64 size) {
     return platform_set_memory(dst, value, size);
 }
 
-char* get_memory_usage_str() {
+void memory_system_register_pool(pool_allocator* pool) {
+    if (!state_ptr) {
+        return;
+    }
+    for (u32 i = 0; i < MAX_REGISTERED_POOLS; ++i) {
+        if (!state_ptr->pools[i]) {
+            state_ptr->pools[i] = pool;
+            return;
+        }
+    }
+    PE_WARN("Pool '%s' not listed in memory stats; more than %u pools exist.", pool->name, MAX_REGISTERED_POOLS);
+}
+
+void memory_system_unregister_pool(pool_allocator* pool) {
+    if (!state_ptr) {
+        return;
+    }
+    for (u32 i = 0; i < MAX_REGISTERED_POOLS; ++i) {
+        if (state_ptr->pools[i] == pool) {
+            state_ptr->pools[i] = 0;
+            return;
+        }
+    }
+}
+
+// Converts a byte count to the largest unit it reaches
+static f32 size_in_units(u64 bytes, const char** out_unit) {
     const u64 gib = (1<<30);
     const u64 mib = (1<<20);
     const u64 kib = (1<<10);
 
+    if (bytes >= gib) {
+        *out_unit = "GiB";
+        return bytes / (f32)gib;
+    } else if (bytes >= mib) {
+        *out_unit = "MiB";
+        return bytes / (f32)mib;
+    } else if (bytes >= kib) {
+        *out_unit = "KiB";
+        return bytes / (f32)kib;
+    }
+    *out_unit = "B";
+    return (f32)bytes;
+}
+
+void memory_get_tag_stats(memory_tag tag, memory_tag_stats* out_stats) {
+    if (!state_ptr) {
+        pe_zero_memory(out_stats, sizeof(memory_tag_stats));
+        return;
+    }
+
+    // Each counter is read on its own, so a concurrent allocation may show up in some and not others
+    tag_counters* counters = &state_ptr->stats.tags[tag];
+    out_stats->allocated_bytes = PE_ATOMIC_LOAD(&counters->allocated, PE_ATOMIC_RELAXED);
+    out_stats->peak_bytes = PE_ATOMIC_LOAD(&counters->peak, PE_ATOMIC_RELAXED);
+    out_stats->allocation_count = PE_ATOMIC_LOAD(&counters->allocation_count, PE_ATOMIC_RELAXED);
+    out_stats->free_count = PE_ATOMIC_LOAD(&counters->free_count, PE_ATOMIC_RELAXED);
+}
+
+char* get_memory_usage_str() {
+    const u64 mib = (1<<20);
+
     char buffer[8000] = "System memory use (tagged):\n";
     u64 offset = strlen(buffer);
 
     for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
-        char unit[4] = "xib";
-        f32 amount = 1.0f;
-        if (state_ptr->stats.tagged_allocations[i] >= gib) {
-            unit[0] = 'G';
-            amount = state_ptr->stats.tagged_allocations[i] / (f32)gib;
-        } else if (state_ptr->stats.tagged_allocations[i] >= mib) {
-            unit[0] = 'M';
-            amount = state_ptr->stats.tagged_allocations[i] / (f32)mib;
-        } else if (state_ptr->stats.tagged_allocations[i] >= kib) {
-            unit[0] = 'K';
-            amount = state_ptr->stats.tagged_allocations[i] / (f32)kib;
-        } else {
-            unit[0] = 'B';
-            unit[1] = 0;
-            amount = (f32)state_ptr->stats.tagged_allocations[i];
-        }
+        memory_tag_stats stats;
+        memory_get_tag_stats(i, &stats);
 
-        offset += snprintf(buffer + offset, 8000 - offset, " %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
+        const char* unit;
+        f32 amount = size_in_units(stats.allocated_bytes, &unit);
+        const char* peak_unit;
+        f32 peak_amount = size_in_units(stats.peak_bytes, &peak_unit);
+
+        offset += snprintf(buffer + offset, 8000 - offset, " %s: %.2f%s (peak %.2f%s), %llu live of %llu allocations\n",
+            memory_tag_strings[i], amount, unit, peak_amount, peak_unit, stats.allocation_count - stats.free_count, stats.allocation_count);
+    }
+
+    if (state_ptr->heap_memory) {
+        u64 heap_size = state_ptr->config.heap_size;
+        u64 heap_used = heap_size - dynamic_allocator_free_space(&state_ptr->heap);
+        offset += snprintf(buffer + offset, 8000 - offset, "Engine heap: %.2fMiB of %.2fMiB in use (including block overhead)\n",
+            heap_used / (f32)mib, heap_size / (f32)mib);
+    }
+
+    for (u32 i = 0; i < MAX_REGISTERED_POOLS; ++i) {
+        pool_allocator* pool = state_ptr->pools[i];
+        if (pool) {
+            f32 occupancy = pool->capacity ? 100.0f * pool->live_count / (f32)pool->capacity : 0.0f;
+            offset += snprintf(buffer + offset, 8000 - offset, "Pool %s (%s): %llu/%llu blocks of %lluB (%.1f%%), peak %llu, %u chunk(s)\n",
+                pool->name, memory_tag_strings[pool->tag], pool->live_count, pool->capacity, pool->element_size, occupancy, pool->peak_count, pool->chunk_count);
+        }
     }
 
     // TODO: change string duplication
+#if PE_PLATFORM_WINDOWS
     char* out_string = _strdup(buffer);
+#else
+    char* out_string = strdup(buffer);
+#endif
     return out_string;
 }
 
 
 u64 get_memory_alloc_count() {
+    u64 count = 0;
     if (state_ptr) {
-        return state_ptr->alloc_count;
+        for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+            count += PE_ATOMIC_LOAD(&state_ptr->stats.tags[i].allocation_count, PE_ATOMIC_RELAXED);
+        }
+    }
+    return count;
+}
+
+u64 get_memory_free_count() {
+    u64 count = 0;
+    if (state_ptr) {
+        for (u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+            count += PE_ATOMIC_LOAD(&state_ptr->stats.tags[i].free_count, PE_ATOMIC_RELAXED);
+        }
     }
-    return 0;
+    return count;
 }
\ No newline at end of file
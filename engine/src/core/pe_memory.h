@@ -11,6 +11,7 @@ typedef enum memory_tag {
     MEMORY_TAG_DICT,
     MEMORY_TAG_RING_QUEUE,
     MEMORY_TAG_BST,
+    MEMORY_TAG_SLOT_MAP,
     MEMORY_TAG_STRING,
     MEMORY_TAG_APPLICATION,
     MEMORY_TAG_JOB,
@@ -22,33 +23,199 @@ typedef enum memory_tag {
     MEMORY_TAG_ENTITY,
     MEMORY_TAG_ENTITY_NODE,
     MEMORY_TAG_SCENE,
+    // Vulkan driver host allocations, by VkSystemAllocationScope
+    MEMORY_TAG_VULKAN_COMMAND,
+    MEMORY_TAG_VULKAN_OBJECT,
+    MEMORY_TAG_VULKAN_CACHE,
+    MEMORY_TAG_VULKAN_DEVICE,
+    MEMORY_TAG_VULKAN_INSTANCE,
 
     MEMORY_TAG_MAX_TAGS
 } memory_tag;
 
+#define MEMORY_TAG_BIT(tag) ((u64)1 << (tag))
+#define MEMORY_TAG_MASK_ALL (MEMORY_TAG_BIT(MEMORY_TAG_MAX_TAGS) - 1)
+
+// Limits on the bytes allocated under one tag. 0 means no limit.
+typedef struct memory_tag_budget {
+    // Crossing this fires EVENT_CODE_MEMORY_BUDGET_EXCEEDED from the next memory_system_update, so caches can evict
+    u64 soft_limit;
+    // Allocations that would cross this fail
+    u64 hard_limit;
+} memory_tag_budget;
+
+typedef struct memory_system_configuration {
+    // Size of the engine heap, reserved once at startup. Allocations that don't fit fail rather than grow it.
+    u64 heap_size;
+    // Tags (one MEMORY_TAG_BIT each) served from the engine heap. Other tags go to the C runtime heap.
+    u64 heap_tag_mask;
+    memory_tag_budget budgets[MEMORY_TAG_MAX_TAGS];
+} memory_system_configuration;
+
 /**
  * @brief Initializes memory system. Call twice; once with state = 0 to get required memory size,
  * then a second time passing allocated memory to state.
  * 
  * @param memory_requirement A pointer to hold the required memory size state
- * @param state 0 if just requesting memory requirement, otherwise allocated block of memory
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory,
+ * aligned to PE_CACHE_LINE_SIZE
+ * @param config Engine heap size and the tags allocated from it
  * @returns True on success; otherwise false.
  */
-PE_API b8 memory_system_initialize(u64* memory_requirement, void* state);
+PE_API b8 memory_system_initialize(u64* memory_requirement, void* state, memory_system_configuration config);
 PE_API void memory_system_shutdown(void* state);
 
+/**
+ * @brief Fires EVENT_CODE_MEMORY_BUDGET_EXCEEDED for each tag that crossed its soft limit since
+ * the last call. Allocations may cross from any thread; the events are fired here, so call it once
+ * per frame from the main thread. A tag that crosses more than once between two calls is reported once.
+ */
+PE_API void memory_system_update();
+
 
+// Blocks from pe_allocate are aligned to at least 16 bytes. Returns 0 if the engine heap is exhausted
+// or the tag's hard limit would be crossed.
 PE_API void* pe_allocate(u64 size, memory_tag tag);
 
+/**
+ * @brief Like pe_allocate, but leaves the contents undefined instead of zeroing them.
+ * For blocks that are overwritten right away, where clearing would only cost bandwidth
+ * and, for large blocks, fault in every page up front. Freed with pe_free.
+ */
+PE_API void* pe_allocate_uninit(u64 size, memory_tag tag);
+
 PE_API void pe_free(void* block, u64 size, memory_tag tag);
 
+/**
+ * @brief Resizes a block from pe_allocate or pe_allocate_uninit. Engine heap blocks grow in place
+ * when the memory behind them is free, so growing an array doesn't always mean a copy.
+ * 
+ * @param block The block to resize. 0 allocates a new block.
+ * @param old_size The size the block was allocated with
+ * @param new_size The size wanted
+ * @param tag The memory tag the block was allocated under
+ * @returns The block, possibly moved, with its first min(old_size, new_size) bytes kept and the
+ * rest undefined. Returns 0 on failure, in which case block is left untouched.
+ */
+PE_API void* pe_reallocate(void* block, u64 old_size, u64 new_size, memory_tag tag);
+
+/**
+ * @brief Allocates a zeroed block whose address is a multiple of alignment.
+ * Memory stats account for the padding and bookkeeping as well.
+ * 
+ * @param size The size of the block in bytes
+ * @param alignment The alignment in bytes. Must be a power of two.
+ * @param tag The memory tag the block is accounted under
+ * @returns The aligned block; must be freed with pe_free_aligned.
+ */
+PE_API void* pe_allocate_aligned(u64 size, u16 alignment, memory_tag tag);
+
+/**
+ * @brief Like pe_allocate_aligned, but leaves the contents undefined instead of zeroing them.
+ * Freed with pe_free_aligned.
+ */
+PE_API void* pe_allocate_aligned_uninit(u64 size, u16 alignment, memory_tag tag);
+
+/**
+ * @brief Frees a block allocated with pe_allocate_aligned. Size and alignment must match the allocation.
+ */
+PE_API void pe_free_aligned(void* block, u64 size, u16 alignment, memory_tag tag);
+
+// Rounds value up to the next multiple of alignment, which must be a power of two
+PE_INLINE u64 pe_align_up(u64 value, u64 alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Returns the size of a regular virtual memory page.
+ */
+PE_API u64 pe_memory_page_size();
+
+/**
+ * @brief Returns the size of a huge page, or the regular page size where huge pages are unsupported.
+ */
+PE_API u64 pe_memory_huge_page_size();
+
+/**
+ * @brief Reserves a range of address space without backing it with memory.
+ * The range must be committed before use. Not tracked in the memory stats until committed.
+ * 
+ * @param size The size of the range in bytes. Should be a multiple of the page size.
+ * @param huge_pages Align the range so it can be backed by transparent huge pages once committed.
+ * @returns The base address of the range, or 0 on failure.
+ */
+PE_API void* pe_memory_reserve(u64 size, b8 huge_pages);
+
+/**
+ * @brief Commits part of a reserved range, making it readable and writable.
+ * Committed pages read as zero until written.
+ * 
+ * @param address Page aligned address inside a reserved range.
+ * @param size The size in bytes to commit. Should be a multiple of the page size.
+ * @param huge_pages Advise the OS to back the range with huge pages.
+ * @param tag The memory tag the committed memory is accounted under.
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 pe_memory_commit(void* address, u64 size, b8 huge_pages, memory_tag tag);
+
+/**
+ * @brief Returns committed pages to the OS while keeping the address range reserved.
+ */
+PE_API void pe_memory_decommit(void* address, u64 size, memory_tag tag);
+
+/**
+ * @brief Releases a whole reserved range. Any committed part should be decommitted first
+ * to keep the memory stats accurate.
+ */
+PE_API void pe_memory_release(void* address, u64 size);
+
+/**
+ * @brief Allocates a zeroed, committed block straight from the OS, bypassing the heap.
+ * Intended for large, long-lived blocks. With huge_pages set, explicit huge pages
+ * are tried first, falling back to transparent huge pages, then to regular pages.
+ * 
+ * @param size The size of the block. Rounded up to the page (or huge page) size.
+ * @param huge_pages Back the block with huge pages when available.
+ * @param tag The memory tag the block is accounted under.
+ * @returns The block, or 0 on failure.
+ */
+PE_API void* pe_allocate_pages(u64 size, b8 huge_pages, memory_tag tag);
+
+/**
+ * @brief Frees a block allocated with pe_allocate_pages. Size and huge_pages must match the allocation.
+ */
+PE_API void pe_free_pages(void* block, u64 size, b8 huge_pages, memory_tag tag);
+
 PE_API void* pe_zero_memory(void* block, u64 size);
 
 PE_API void* pe_copy_memory(void* dst, const void* src, u64 size);
 
+// Like pe_copy_memory, but the ranges may overlap
+PE_API void* pe_move_memory(void* dst, const void* src, u64 size);
+
 PE_API void* pe_set_memory(void* dst, i32 value, u64 size);
 
 
+typedef struct memory_tag_stats {
+    // Bytes currently allocated, and the most ever allocated at once
+    u64 allocated_bytes;
+    u64 peak_bytes;
+    // Live allocations are allocation_count - free_count
+    u64 allocation_count;
+    u64 free_count;
+} memory_tag_stats;
+
+// Safe to call from any thread while others allocate; the counters are read individually.
+PE_API void memory_get_tag_stats(memory_tag tag, memory_tag_stats* out_stats);
+
+struct pool_allocator;
+
+// Lists a pool's occupancy in get_memory_usage_str. Done by pool_allocator_create and pool_allocator_destroy.
+PE_API void memory_system_register_pool(struct pool_allocator* pool);
+PE_API void memory_system_unregister_pool(struct pool_allocator* pool);
+
 PE_API char* get_memory_usage_str();
 
-PE_API u64 get_memory_alloc_count();
\ No newline at end of file
+// Totals across all tags since the memory system started
+PE_API u64 get_memory_alloc_count();
+PE_API u64 get_memory_free_count();
\ No newline at end of file
@@ -12,7 +12,7 @@ u64 string_length(const char* str) {
 
 char* string_duplicate(const char* str) {
     u64 length = string_length(str);
-    char* copy = pe_allocate(length + 1, MEMORY_TAG_STRING);
+    char* copy = pe_allocate_uninit(length + 1, MEMORY_TAG_STRING);
     pe_copy_memory(copy, str, length + 1);
     return copy;
 }
@@ -22,6 +22,10 @@ b8 strings_equal(const char* str0, const char* str1) {
     return strcmp(str0, str1) == 0;
 }
 
+b8 strings_equal_n(const char* str0, const char* str1, u64 length) {
+    return strncmp(str0, str1, length) == 0;
+}
+
 i32 string_format(char* dest, const char* format, ...) {
     if (dest) {
         va_list arg_ptr;
@@ -10,6 +10,9 @@ PE_API char* string_duplicate(const char* str);
 // Case-sensitive string comparison. true if the same, otherwise false
 PE_API b8 strings_equal(const char* str0, const char* str1);
 
+// Case-sensitive comparison of up to length characters. true if the same, otherwise false
+PE_API b8 strings_equal_n(const char* str0, const char* str1, u64 length);
+
 // Performs string formatting to dest given format string and parameters
 PE_API i32 string_format(char* dest, const char* format, ...);
 
@@ -20,4 +23,79 @@ PE_API i32 string_format(char* dest, const char* format, ...);
  * @param va_list The variadic argument list
  * @returns The size od the data written.
  */
-PE_API i32 string_format_v(char* dest, const char* format, void* va_listp);
\ No newline at end of file
+PE_API i32 string_format_v(char* dest, const char* format, void* va_listp);
+
+// String hashing, after wyhash (final version 4). Inline so hashes of literals fold to constants
+// in optimized builds; see STRING_ID in core/string_id.h. Not for untrusted input in security sensitive uses.
+// Uses __uint128_t and __builtin_memcpy, so like the atomics in defines.h it needs clang or gcc.
+
+PE_INLINE u64 _string_hash_mix(u64 a, u64 b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (u64)product ^ (u64)(product >> 64);
+}
+
+PE_INLINE u64 _string_hash_read8(const u8* p) {
+    u64 value;
+    __builtin_memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+PE_INLINE u64 _string_hash_read4(const u8* p) {
+    u32 value;
+    __builtin_memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Hashes length bytes of str with a fast, well distributed 64 bit hash.
+ * The same bytes always hash to the same value, on every platform and run.
+ */
+PE_INLINE u64 string_hash(const char* str, u64 length) {
+    const u64 secret0 = 0xa0761d6478bd642full;
+    const u64 secret1 = 0xe7037ed1a0b428dbull;
+    const u64 secret2 = 0x8ebc6af09c88c6e3ull;
+    const u64 secret3 = 0x589965cc75374cc3ull;
+
+    const u8* p = (const u8*)str;
+    u64 seed = _string_hash_mix(secret0, secret1);
+    u64 a;
+    u64 b;
+    if (length <= 16) {
+        if (length >= 4) {
+            u64 middle = (length >> 3) << 2;
+            a = (_string_hash_read4(p) << 32) | _string_hash_read4(p + middle);
+            b = (_string_hash_read4(p + length - 4) << 32) | _string_hash_read4(p + length - 4 - middle);
+        } else if (length > 0) {
+            a = ((u64)p[0] << 16) | ((u64)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        u64 remaining = length;
+        if (remaining > 48) {
+            u64 seed1 = seed;
+            u64 seed2 = seed;
+            do {
+                seed = _string_hash_mix(_string_hash_read8(p) ^ secret1, _string_hash_read8(p + 8) ^ seed);
+                seed1 = _string_hash_mix(_string_hash_read8(p + 16) ^ secret2, _string_hash_read8(p + 24) ^ seed1);
+                seed2 = _string_hash_mix(_string_hash_read8(p + 32) ^ secret3, _string_hash_read8(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16) {
+            seed = _string_hash_mix(_string_hash_read8(p) ^ secret1, _string_hash_read8(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = _string_hash_read8(p + remaining - 16);
+        b = _string_hash_read8(p + remaining - 8);
+    }
+
+    a ^= secret1;
+    b ^= seed;
+    __uint128_t product = (__uint128_t)a * b;
+    return _string_hash_mix((u64)product ^ secret0 ^ length, (u64)(product >> 64) ^ secret1);
+}
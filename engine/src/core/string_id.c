@@ -0,0 +1,202 @@
+#include "core/string_id.h"
+
+#include "core/pe_memory.h"
+#include "core/logger.h"
+#include "memory/linear_allocator.h"
+#include "platform/platform.h"
+
+// Address space reserved for string storage; only what is used gets committed
+#define STRING_STORAGE_RESERVE (64 * 1024 * 1024)
+
+#define MIN_TABLE_CAPACITY 64
+
+typedef struct string_id_entry {
+    // STRING_ID_INVALID while the entry is free. Stored last, with release, when filling the entry.
+    string_id id;
+    const char* str;
+} string_id_entry;
+
+// Open-addressing table from id to string. Entries are only ever added, so once a reader sees
+// an id its string is set for good.
+typedef struct string_id_table {
+    // A power of two
+    u64 capacity;
+    // The table this one replaced. Readers may still be probing it, so it is kept until shutdown.
+    struct string_id_table* retired;
+    string_id_entry entries[];
+} string_id_table;
+
+typedef struct string_id_system_state {
+    // Current table. Swapped, with release, for a larger one as it fills.
+    string_id_table* table;
+    // The fields below belong to writers, under write_mutex
+    u64 count;
+    platform_mutex write_mutex;
+    // One copy of each interned string; never freed before shutdown
+    linear_allocator strings;
+} string_id_system_state;
+
+static string_id_system_state* state_ptr;
+
+static string_id_table* table_create(u64 capacity) {
+    // Zeroed, leaving every entry free
+    string_id_table* table = pe_allocate(sizeof(string_id_table) + capacity * sizeof(string_id_entry), MEMORY_TAG_STRING);
+    if (table) {
+        table->capacity = capacity;
+    }
+    return table;
+}
+
+static void table_destroy(string_id_table* table) {
+    pe_free(table, sizeof(string_id_table) + table->capacity * sizeof(string_id_entry), MEMORY_TAG_STRING);
+}
+
+// Writers only. Returns the free entry id belongs in.
+static string_id_entry* table_find_free(string_id_table* table, string_id id) {
+    u64 mask = table->capacity - 1;
+    u64 index = id & mask;
+    while (table->entries[index].id != STRING_ID_INVALID) {
+        index = (index + 1) & mask;
+    }
+    return &table->entries[index];
+}
+
+// Swaps in a table twice the size. Writers only.
+static b8 table_grow() {
+    string_id_table* old_table = state_ptr->table;
+    string_id_table* new_table = table_create(old_table->capacity * 2);
+    if (!new_table) {
+        PE_ERROR("string_id - failed to grow the string table to %llu entries.", old_table->capacity * 2);
+        return false;
+    }
+
+    // Not visible to readers yet, so plain writes do
+    for (u64 i = 0; i < old_table->capacity; ++i) {
+        if (old_table->entries[i].id != STRING_ID_INVALID) {
+            *table_find_free(new_table, old_table->entries[i].id) = old_table->entries[i];
+        }
+    }
+    new_table->retired = old_table;
+
+    PE_ATOMIC_STORE(&state_ptr->table, new_table, PE_ATOMIC_RELEASE);
+    return true;
+}
+
+b8 string_id_system_initialize(u64* memory_requirement, void* state, u32 initial_capacity) {
+    *memory_requirement = sizeof(string_id_system_state);
+    if (!state) {
+        return true;
+    }
+
+    pe_zero_memory(state, sizeof(string_id_system_state));
+    string_id_system_state* new_state = state;
+
+    // Keep the table at most 3/4 full
+    u64 capacity = MIN_TABLE_CAPACITY;
+    while (capacity * 3 / 4 < initial_capacity) {
+        capacity <<= 1;
+    }
+    new_state->table = table_create(capacity);
+    if (!new_state->table) {
+        PE_ERROR("string_id_system_initialize - failed to allocate the string table.");
+        return false;
+    }
+    if (!linear_allocator_create_virtual(STRING_STORAGE_RESERVE, false, &new_state->strings)) {
+        PE_ERROR("string_id_system_initialize - failed to reserve string storage.");
+        table_destroy(new_state->table);
+        return false;
+    }
+    if (!platform_mutex_create(&new_state->write_mutex)) {
+        PE_ERROR("string_id_system_initialize - failed to create the write mutex.");
+        linear_allocator_destroy(&new_state->strings);
+        table_destroy(new_state->table);
+        return false;
+    }
+
+    state_ptr = new_state;
+    PE_INFO("String ID subsystem initialized.");
+    return true;
+}
+
+void string_id_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    string_id_table* table = state_ptr->table;
+    while (table) {
+        string_id_table* retired = table->retired;
+        table_destroy(table);
+        table = retired;
+    }
+    linear_allocator_destroy(&state_ptr->strings);
+    platform_mutex_destroy(&state_ptr->write_mutex);
+    state_ptr = 0;
+}
+
+const char* string_id_lookup(string_id id) {
+    if (!state_ptr || id == STRING_ID_INVALID) {
+        return 0;
+    }
+
+    // Acquire pairs with the release when a table or entry is published, so its contents are visible
+    string_id_table* table = PE_ATOMIC_LOAD(&state_ptr->table, PE_ATOMIC_ACQUIRE);
+    u64 mask = table->capacity - 1;
+    for (u64 index = id & mask;; index = (index + 1) & mask) {
+        string_id entry_id = PE_ATOMIC_LOAD(&table->entries[index].id, PE_ATOMIC_ACQUIRE);
+        if (entry_id == id) {
+            return table->entries[index].str;
+        }
+        if (entry_id == STRING_ID_INVALID) {
+            return 0;
+        }
+    }
+}
+
+string_id string_id_intern(const char* str) {
+    if (!state_ptr || !str) {
+        PE_ERROR("string_id_intern - requires an initialized string ID system and a string.");
+        return STRING_ID_INVALID;
+    }
+
+    u64 length = string_length(str);
+    string_id id = _string_id_from_hash(string_hash(str, length));
+
+    // Most strings were interned before; take the lock only for new ones
+    const char* interned = string_id_lookup(id);
+    if (!interned) {
+        platform_mutex_lock(&state_ptr->write_mutex);
+        // Another thread may have added it in the meantime
+        interned = string_id_lookup(id);
+        if (!interned) {
+            if ((state_ptr->count + 1) * 4 > state_ptr->table->capacity * 3 && !table_grow()) {
+                platform_mutex_unlock(&state_ptr->write_mutex);
+                return STRING_ID_INVALID;
+            }
+
+            char* copy = linear_allocator_allocate(&state_ptr->strings, length + 1);
+            if (!copy) {
+                platform_mutex_unlock(&state_ptr->write_mutex);
+                PE_ERROR("string_id_intern - string storage is full.");
+                return STRING_ID_INVALID;
+            }
+            pe_copy_memory(copy, str, length + 1);
+
+            string_id_entry* entry = table_find_free(state_ptr->table, id);
+            entry->str = copy;
+            // Publishes the string along with the id
+            PE_ATOMIC_STORE(&entry->id, id, PE_ATOMIC_RELEASE);
+            state_ptr->count++;
+            interned = copy;
+        }
+        platform_mutex_unlock(&state_ptr->write_mutex);
+    }
+
+#if defined(_DEBUG)
+    if (!strings_equal(interned, str)) {
+        PE_ERROR("string_id_intern - '%s' and '%s' hash to the same id %llu.", str, interned, id);
+    }
+#endif
+
+    return id;
+}
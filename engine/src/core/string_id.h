@@ -0,0 +1,50 @@
+#pragma once
+
+#include "defines.h"
+#include "core/pe_string.h"
+
+/*
+String interning. A string_id is the 64 bit hash of a string, so ids are stable across runs
+and can be computed without the table, including at compile time for literals. Interning
+stores one copy of each distinct string, so an id can be turned back into its string.
+
+Comparing names becomes comparing ids. Lookups take no locks; interning a new string locks
+only against other threads interning new strings.
+*/
+
+typedef u64 string_id;
+
+// Never the id of a string
+#define STRING_ID_INVALID 0
+
+PE_INLINE string_id _string_id_from_hash(u64 hash) {
+    // 0 is reserved for STRING_ID_INVALID
+    return hash ? hash : 1;
+}
+
+// The id of a string, without interning it
+PE_INLINE string_id string_id_hash(const char* str) {
+    return _string_id_from_hash(string_hash(str, string_length(str)));
+}
+
+// The id of a string literal. Folds to a constant in optimized builds.
+#define STRING_ID(literal) _string_id_from_hash(string_hash("" literal, sizeof(literal) - 1))
+
+/**
+ * @brief Initializes the string interning system. Call twice; once with state = 0 to get the
+ * required memory size, then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory
+ * @param initial_capacity The number of strings to make room for up front
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 string_id_system_initialize(u64* memory_requirement, void* state, u32 initial_capacity);
+PE_API void string_id_system_shutdown(void* state);
+
+// Interns str and returns its id. Any thread. Returns STRING_ID_INVALID on failure.
+PE_API string_id string_id_intern(const char* str);
+
+// Returns the interned string for id, or 0 if no string with that id was interned. Any thread, lock-free.
+// The string stays valid until the system shuts down.
+PE_API const char* string_id_lookup(string_id id);
@@ -88,6 +88,12 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 bytes.");
     #error "Unknown platform"
 #endif
 
+// Headless builds (-DPE_HEADLESS=1) swap the windowing half of the platform layer
+// for platform_headless.c and render into offscreen targets instead of a swapchain.
+#ifndef PE_HEADLESS
+    #define PE_HEADLESS 0
+#endif
+
 #ifdef PE_EXPORT
 // Exports
     #ifdef _MSC_VER
@@ -114,4 +120,43 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 bytes.");
 #else
 #define PE_INLINE static inline
 #define PE_NOINLINE
-#endif 
\ No newline at end of file
+#endif 
+
+// Data written by different threads should sit at least this far apart to avoid false sharing
+#define PE_CACHE_LINE_SIZE 64
+
+// Atomics. Thin wrappers over the compiler builtins, which follow the C11 memory model
+// but work on plain (non _Atomic) variables.
+#if defined(__clang__) || defined(__GNUC__)
+#define PE_ATOMIC_RELAXED __ATOMIC_RELAXED
+#define PE_ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#define PE_ATOMIC_RELEASE __ATOMIC_RELEASE
+#define PE_ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#define PE_ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+#define PE_ATOMIC_LOAD(ptr, order) __atomic_load_n(ptr, order)
+#define PE_ATOMIC_STORE(ptr, value, order) __atomic_store_n(ptr, value, order)
+#define PE_ATOMIC_EXCHANGE(ptr, value, order) __atomic_exchange_n(ptr, value, order)
+#define PE_ATOMIC_FETCH_ADD(ptr, value, order) __atomic_fetch_add(ptr, value, order)
+#define PE_ATOMIC_FETCH_SUB(ptr, value, order) __atomic_fetch_sub(ptr, value, order)
+#define PE_ATOMIC_FETCH_AND(ptr, value, order) __atomic_fetch_and(ptr, value, order)
+#define PE_ATOMIC_FETCH_OR(ptr, value, order) __atomic_fetch_or(ptr, value, order)
+// On failure, *expected_ptr is updated with the current value.
+#define PE_ATOMIC_COMPARE_EXCHANGE(ptr, expected_ptr, desired, success_order, failure_order) \
+    __atomic_compare_exchange_n(ptr, expected_ptr, desired, false, success_order, failure_order)
+// May fail spuriously; cheaper inside retry loops on LL/SC architectures.
+#define PE_ATOMIC_COMPARE_EXCHANGE_WEAK(ptr, expected_ptr, desired, success_order, failure_order) \
+    __atomic_compare_exchange_n(ptr, expected_ptr, desired, true, success_order, failure_order)
+#define PE_ATOMIC_THREAD_FENCE(order) __atomic_thread_fence(order)
+#else
+#error "Atomics require clang or gcc builtins."
+#endif
+
+// Spin-wait hint. Lets the sibling hyperthread run and saves power in busy loops.
+#if defined(__x86_64__) || defined(_M_X64)
+#define PE_CPU_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define PE_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#define PE_CPU_PAUSE()
+#endif
@@ -0,0 +1,366 @@
+#include "dynamic_allocator.h"
+
+#include "core/pe_memory.h"
+#include "core/logger.h"
+
+// Every block starts with a header; blocks and payloads are 16 byte aligned.
+// Free blocks also hold free list links and end with a footer repeating their size,
+// which lets the following block find them when coalescing.
+#define BLOCK_ALIGNMENT 16
+#define HEADER_SIZE 16
+#define FOOTER_SIZE 8
+// Header, links and footer of a free block
+#define MIN_BLOCK_SIZE 48
+
+#define BLOCK_FLAG_USED 0x1
+// Set when the block in front is free, meaning its footer is valid
+#define BLOCK_FLAG_PREV_FREE 0x2
+#define BLOCK_SIZE_MASK (~(u64)(BLOCK_ALIGNMENT - 1))
+
+// Class n holds free blocks of [2^n, 2^(n+1)) bytes
+#define SIZE_CLASS_COUNT 64
+
+// Blocks looked at in the exact size class before settling for a larger class
+#define SIZE_CLASS_SCAN_LIMIT 8
+
+typedef struct block_header {
+    u64 size_flags;
+    // Always 0 in a block header. Aligned allocations store the distance back to the
+    // real payload in the same position in front of the pointer they hand out.
+    u64 payload_offset;
+    // Free blocks only
+    struct block_header* next_free;
+    struct block_header* prev_free;
+} block_header;
+
+typedef struct dynamic_allocator_state {
+    u64 total_size;
+    u64 free_space;
+    // Bit per size class with at least one free block
+    u64 non_empty_classes;
+    u8* heap_start;
+    u8* heap_end;
+    block_header* free_lists[SIZE_CLASS_COUNT];
+} dynamic_allocator_state;
+
+PE_INLINE u64 block_size(const block_header* block) {
+    return block->size_flags & BLOCK_SIZE_MASK;
+}
+
+PE_INLINE u32 size_class(u64 size) {
+    return 63 - __builtin_clzll(size);
+}
+
+PE_INLINE block_header* block_next(dynamic_allocator_state* state, block_header* block) {
+    u8* next = (u8*)block + block_size(block);
+    return next < state->heap_end ? (block_header*)next : 0;
+}
+
+static void block_write_footer(block_header* block) {
+    *(u64*)((u8*)block + block_size(block) - FOOTER_SIZE) = block_size(block);
+}
+
+static void free_list_insert(dynamic_allocator_state* state, block_header* block) {
+    u32 class_index = size_class(block_size(block));
+    block->prev_free = 0;
+    block->next_free = state->free_lists[class_index];
+    if (block->next_free) {
+        block->next_free->prev_free = block;
+    }
+    state->free_lists[class_index] = block;
+    state->non_empty_classes |= (u64)1 << class_index;
+}
+
+static void free_list_remove(dynamic_allocator_state* state, block_header* block) {
+    u32 class_index = size_class(block_size(block));
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        state->free_lists[class_index] = block->next_free;
+    }
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (!state->free_lists[class_index]) {
+        state->non_empty_classes &= ~((u64)1 << class_index);
+    }
+}
+
+// Size of the block holding a payload of size bytes
+PE_INLINE u64 block_size_for(u64 size) {
+    u64 required = pe_align_up(size + HEADER_SIZE, BLOCK_ALIGNMENT);
+    return required < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : required;
+}
+
+static block_header* free_list_find(dynamic_allocator_state* state, u64 size) {
+    // Blocks in the request's own class may be too small, so check a few
+    u32 class_index = size_class(size);
+    block_header* block = state->free_lists[class_index];
+    for (u32 i = 0; block && i < SIZE_CLASS_SCAN_LIMIT; ++i, block = block->next_free) {
+        if (block_size(block) >= size) {
+            return block;
+        }
+    }
+
+    // Any block of a larger class fits; take the smallest such class
+    if (class_index + 1 >= SIZE_CLASS_COUNT) {
+        return 0;
+    }
+    u64 larger_classes = state->non_empty_classes & (~(u64)0 << (class_index + 1));
+    if (!larger_classes) {
+        return 0;
+    }
+    return state->free_lists[__builtin_ctzll(larger_classes)];
+}
+
+b8 dynamic_allocator_create(u64 total_size, u64* memory_requirement, void* memory, dynamic_allocator* out_allocator) {
+    if (total_size < MIN_BLOCK_SIZE) {
+        PE_ERROR("dynamic_allocator_create - total_size must be at least %uB.", MIN_BLOCK_SIZE);
+        return false;
+    }
+
+    u64 state_size = pe_align_up(sizeof(dynamic_allocator_state), BLOCK_ALIGNMENT);
+    u64 heap_size = total_size & BLOCK_SIZE_MASK;
+    *memory_requirement = state_size + heap_size;
+    if (!memory) {
+        return true;
+    }
+
+    if ((u64)memory % BLOCK_ALIGNMENT != 0) {
+        PE_ERROR("dynamic_allocator_create - memory must be %u byte aligned.", BLOCK_ALIGNMENT);
+        return false;
+    }
+
+    out_allocator->memory = memory;
+    dynamic_allocator_state* state = memory;
+    pe_zero_memory(state, sizeof(dynamic_allocator_state));
+    state->total_size = heap_size;
+    state->free_space = heap_size;
+    state->heap_start = (u8*)memory + state_size;
+    state->heap_end = state->heap_start + heap_size;
+
+    // Start out with one free block spanning the whole heap
+    block_header* block = (block_header*)state->heap_start;
+    block->size_flags = heap_size;
+    block->payload_offset = 0;
+    block_write_footer(block);
+    free_list_insert(state, block);
+
+    return true;
+}
+
+void dynamic_allocator_destroy(dynamic_allocator* allocator) {
+    if (allocator && allocator->memory) {
+        pe_zero_memory(allocator->memory, sizeof(dynamic_allocator_state));
+        allocator->memory = 0;
+    }
+}
+
+void* dynamic_allocator_allocate(dynamic_allocator* allocator, u64 size) {
+    if (!allocator || !allocator->memory || size == 0) {
+        PE_ERROR("dynamic_allocator_allocate - requires a valid allocator and a size above 0.");
+        return 0;
+    }
+
+    dynamic_allocator_state* state = allocator->memory;
+    u64 required = block_size_for(size);
+
+    block_header* block = free_list_find(state, required);
+    if (!block) {
+        PE_ERROR("dynamic_allocator_allocate - no free block large enough for %lluB (%lluB free in total).", size, state->free_space);
+        return 0;
+    }
+    free_list_remove(state, block);
+
+    u64 available = block_size(block);
+    if (available - required >= MIN_BLOCK_SIZE) {
+        // Split off the tail as a new free block. The block behind it already knows its neighbour is free.
+        block_header* remainder = (block_header*)((u8*)block + required);
+        remainder->size_flags = available - required;
+        remainder->payload_offset = 0;
+        block_write_footer(remainder);
+        free_list_insert(state, remainder);
+    } else {
+        // Hand out the whole block; too little would be left to track
+        required = available;
+        block_header* next = block_next(state, block);
+        if (next) {
+            next->size_flags &= ~(u64)BLOCK_FLAG_PREV_FREE;
+        }
+    }
+
+    // Free blocks never border each other, so the block in front of this one is in use
+    block->size_flags = required | BLOCK_FLAG_USED;
+    block->payload_offset = 0;
+    state->free_space -= required;
+
+    return (u8*)block + HEADER_SIZE;
+}
+
+void* dynamic_allocator_allocate_aligned(dynamic_allocator* allocator, u64 size, u16 alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        PE_ERROR("dynamic_allocator_allocate_aligned - alignment %u is not a power of two.", alignment);
+        return 0;
+    }
+    if (alignment <= BLOCK_ALIGNMENT) {
+        return dynamic_allocator_allocate(allocator, size);
+    }
+
+    // Payloads are already 16 byte aligned, so that much less padding is ever needed
+    u8* payload = dynamic_allocator_allocate(allocator, size + alignment - BLOCK_ALIGNMENT);
+    if (!payload) {
+        return 0;
+    }
+
+    u8* aligned = (u8*)pe_align_up((u64)payload, alignment);
+    if (aligned != payload) {
+        // At least 16 bytes in, so this lands inside the padding
+        *((u64*)aligned - 1) = (u64)(aligned - payload);
+    }
+    return aligned;
+}
+
+b8 dynamic_allocator_resize(dynamic_allocator* allocator, void* block, u64 size) {
+    if (!allocator || !allocator->memory || !block || size == 0) {
+        PE_ERROR("dynamic_allocator_resize - requires a valid allocator, block and a size above 0.");
+        return false;
+    }
+    if (!dynamic_allocator_owns(allocator, block)) {
+        PE_ERROR("dynamic_allocator_resize - block %p is not owned by this allocator.", block);
+        return false;
+    }
+    if (*((u64*)block - 1) != 0) {
+        // Moved forward for alignment; the header isn't where resizing expects it
+        return false;
+    }
+
+    dynamic_allocator_state* state = allocator->memory;
+    block_header* header = (block_header*)((u8*)block - HEADER_SIZE);
+    u64 prev_free_flag = header->size_flags & BLOCK_FLAG_PREV_FREE;
+    u64 current = block_size(header);
+    u64 required = block_size_for(size);
+    block_header* next = block_next(state, header);
+
+    if (required <= current) {
+        if (current - required < MIN_BLOCK_SIZE) {
+            // Too little to give back; the block already fits
+            return true;
+        }
+
+        // Give the tail back, merged with the following block if that is free too
+        block_header* tail = (block_header*)((u8*)header + required);
+        u64 tail_size = current - required;
+        if (next && !(next->size_flags & BLOCK_FLAG_USED)) {
+            free_list_remove(state, next);
+            tail_size += block_size(next);
+        }
+        tail->size_flags = tail_size;
+        tail->payload_offset = 0;
+        block_write_footer(tail);
+        free_list_insert(state, tail);
+
+        block_header* after_tail = block_next(state, tail);
+        if (after_tail) {
+            after_tail->size_flags |= BLOCK_FLAG_PREV_FREE;
+        }
+
+        header->size_flags = required | BLOCK_FLAG_USED | prev_free_flag;
+        state->free_space += current - required;
+        return true;
+    }
+
+    // Growing needs a free neighbour behind this block with enough room
+    if (!next || (next->size_flags & BLOCK_FLAG_USED) || current + block_size(next) < required) {
+        return false;
+    }
+
+    free_list_remove(state, next);
+    u64 available = current + block_size(next);
+    if (available - required >= MIN_BLOCK_SIZE) {
+        // The block after the remainder already knows its neighbour is free
+        block_header* remainder = (block_header*)((u8*)header + required);
+        remainder->size_flags = available - required;
+        remainder->payload_offset = 0;
+        block_write_footer(remainder);
+        free_list_insert(state, remainder);
+    } else {
+        // Absorb the whole neighbour; the block after it now follows a used block
+        required = available;
+    }
+
+    header->size_flags = required | BLOCK_FLAG_USED | prev_free_flag;
+    if (required == available) {
+        block_header* after = block_next(state, header);
+        if (after) {
+            after->size_flags &= ~(u64)BLOCK_FLAG_PREV_FREE;
+        }
+    }
+    state->free_space -= required - current;
+    return true;
+}
+
+b8 dynamic_allocator_free(dynamic_allocator* allocator, void* block) {
+    if (!allocator || !allocator->memory || !block) {
+        PE_ERROR("dynamic_allocator_free - requires a valid allocator and block.");
+        return false;
+    }
+
+    dynamic_allocator_state* state = allocator->memory;
+    if (!dynamic_allocator_owns(allocator, block)) {
+        PE_ERROR("dynamic_allocator_free - block %p is not owned by this allocator.", block);
+        return false;
+    }
+
+    u8* payload = (u8*)block - *((u64*)block - 1);
+    block_header* header = (block_header*)(payload - HEADER_SIZE);
+    if (!(header->size_flags & BLOCK_FLAG_USED)) {
+        PE_ERROR("dynamic_allocator_free - block %p is already free.", block);
+        return false;
+    }
+
+    u64 size = block_size(header);
+    state->free_space += size;
+
+    // Merge with the following block
+    block_header* next = block_next(state, header);
+    if (next && !(next->size_flags & BLOCK_FLAG_USED)) {
+        free_list_remove(state, next);
+        size += block_size(next);
+    }
+
+    // Merge with the preceding block
+    if (header->size_flags & BLOCK_FLAG_PREV_FREE) {
+        u64 prev_size = *(u64*)((u8*)header - FOOTER_SIZE);
+        block_header* prev = (block_header*)((u8*)header - prev_size);
+        free_list_remove(state, prev);
+        header = prev;
+        size += prev_size;
+    }
+
+    header->size_flags = size;
+    header->payload_offset = 0;
+    block_write_footer(header);
+    free_list_insert(state, header);
+
+    next = block_next(state, header);
+    if (next) {
+        next->size_flags |= BLOCK_FLAG_PREV_FREE;
+    }
+
+    return true;
+}
+
+b8 dynamic_allocator_owns(dynamic_allocator* allocator, const void* block) {
+    if (!allocator || !allocator->memory) {
+        return false;
+    }
+    dynamic_allocator_state* state = allocator->memory;
+    return (const u8*)block >= state->heap_start && (const u8*)block < state->heap_end;
+}
+
+u64 dynamic_allocator_free_space(dynamic_allocator* allocator) {
+    if (!allocator || !allocator->memory) {
+        return 0;
+    }
+    return ((dynamic_allocator_state*)allocator->memory)->free_space;
+}
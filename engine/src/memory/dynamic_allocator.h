@@ -0,0 +1,51 @@
+#pragma once
+
+#include "defines.h"
+
+// General purpose allocator over a single fixed block. Free blocks are kept in lists segregated
+// by power-of-two size class, and merged with free neighbours on free, so allocation and free
+// cost does not grow with the number of live allocations. Not thread safe.
+typedef struct dynamic_allocator {
+    void* memory;
+} dynamic_allocator;
+
+/**
+ * @brief Creates a dynamic allocator. Call twice; once with memory = 0 to get the required memory size,
+ * then a second time passing a block of that size to memory.
+ *
+ * @param total_size The number of bytes available for allocations, including per-block overhead
+ * @param memory_requirement A pointer to hold the required memory size
+ * @param memory 0 if just requesting memory requirement, otherwise a 16 byte aligned block of memory
+ * @param out_allocator A pointer to hold the allocator
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 dynamic_allocator_create(u64 total_size, u64* memory_requirement, void* memory, dynamic_allocator* out_allocator);
+PE_API void dynamic_allocator_destroy(dynamic_allocator* allocator);
+
+// Allocates size bytes aligned to 16 bytes. Returns 0 if no free block is large enough.
+PE_API void* dynamic_allocator_allocate(dynamic_allocator* allocator, u64 size);
+
+// Allocates size bytes aligned to alignment, a power of two. Returns 0 if no free block is large enough.
+PE_API void* dynamic_allocator_allocate_aligned(dynamic_allocator* allocator, u64 size, u16 alignment);
+
+/**
+ * @brief Resizes a block from dynamic_allocator_allocate without moving it. Shrinking always
+ * succeeds; growing succeeds if the block behind this one is free and large enough to absorb.
+ * Contents up to the smaller of the two sizes are kept.
+ * 
+ * @param allocator The allocator owning the block
+ * @param block The block to resize. Blocks from dynamic_allocator_allocate_aligned with extra
+ * alignment can't be resized and always fail.
+ * @param size The new size in bytes
+ * @returns True if the block now holds size bytes; otherwise false, leaving it untouched.
+ */
+PE_API b8 dynamic_allocator_resize(dynamic_allocator* allocator, void* block, u64 size);
+
+// Frees a block from either allocate function. Returns false for blocks not owned by the allocator.
+PE_API b8 dynamic_allocator_free(dynamic_allocator* allocator, void* block);
+
+// True if block lies within the memory managed by the allocator.
+PE_API b8 dynamic_allocator_owns(dynamic_allocator* allocator, const void* block);
+
+// Total free bytes. Not necessarily contiguous.
+PE_API u64 dynamic_allocator_free_space(dynamic_allocator* allocator);
@@ -0,0 +1,104 @@
+#include "frame_allocator.h"
+
+#include "core/logger.h"
+#include "core/pe_memory.h"
+#include "memory/linear_allocator.h"
+
+typedef struct frame_allocator_state {
+    // All buffers share one block of pages
+    void* memory;
+    u64 buffer_size;
+    u32 buffer_count;
+    u32 current_buffer;
+    u64 peak_usage;
+    linear_allocator buffers[FRAME_ALLOCATOR_MAX_BUFFERS];
+} frame_allocator_state;
+
+static frame_allocator_state* state_ptr;
+
+b8 frame_allocator_system_initialize(u64* memory_requirement, void* state, u64 buffer_size, u32 buffer_count) {
+    *memory_requirement = sizeof(frame_allocator_state);
+    if (state == 0) {
+        return true;
+    }
+
+    if (buffer_count < 2 || buffer_count > FRAME_ALLOCATOR_MAX_BUFFERS) {
+        PE_ERROR("frame_allocator_system_initialize - buffer_count must be between 2 and %u.", FRAME_ALLOCATOR_MAX_BUFFERS);
+        return false;
+    }
+
+    state_ptr = state;
+    pe_zero_memory(state_ptr, sizeof(frame_allocator_state));
+    state_ptr->buffer_size = pe_align_up(buffer_size, 16);
+    state_ptr->buffer_count = buffer_count;
+
+    state_ptr->memory = pe_allocate_pages(state_ptr->buffer_size * buffer_count, true, MEMORY_TAG_LINEAR_ALLOCATOR);
+    if (!state_ptr->memory) {
+        PE_ERROR("Failed to allocate %u frame buffers of %lluB.", buffer_count, state_ptr->buffer_size);
+        state_ptr = 0;
+        return false;
+    }
+
+    for (u32 i = 0; i < buffer_count; ++i) {
+        linear_allocator_create(state_ptr->buffer_size, (u8*)state_ptr->memory + state_ptr->buffer_size * i, &state_ptr->buffers[i]);
+    }
+
+    return true;
+}
+
+void frame_allocator_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    for (u32 i = 0; i < state_ptr->buffer_count; ++i) {
+        linear_allocator_destroy(&state_ptr->buffers[i]);
+    }
+    pe_free_pages(state_ptr->memory, state_ptr->buffer_size * state_ptr->buffer_count, true, MEMORY_TAG_LINEAR_ALLOCATOR);
+
+    state_ptr = 0;
+}
+
+void frame_allocator_begin_frame() {
+    if (!state_ptr) {
+        return;
+    }
+
+    linear_allocator* current = &state_ptr->buffers[state_ptr->current_buffer];
+    if (current->allocated > state_ptr->peak_usage) {
+        state_ptr->peak_usage = current->allocated;
+    }
+
+    state_ptr->current_buffer = (state_ptr->current_buffer + 1) % state_ptr->buffer_count;
+
+    // Blocks are handed out zeroed; fresh pages already are
+    linear_allocator_free_all(&state_ptr->buffers[state_ptr->current_buffer], true);
+}
+
+void* frame_allocate(u64 size) {
+    if (!state_ptr) {
+        PE_ERROR("frame_allocate called before the frame allocator was initialized.");
+        return 0;
+    }
+
+    // Keep every block 16 byte aligned, as pe_allocate does
+    return linear_allocator_allocate_aligned(&state_ptr->buffers[state_ptr->current_buffer], size, 16);
+}
+
+void* frame_allocate_aligned(u64 size, u16 alignment) {
+    if (!state_ptr) {
+        PE_ERROR("frame_allocate_aligned called before the frame allocator was initialized.");
+        return 0;
+    }
+
+    return linear_allocator_allocate_aligned(&state_ptr->buffers[state_ptr->current_buffer], size, alignment);
+}
+
+u64 frame_allocator_peak_usage() {
+    if (!state_ptr) {
+        return 0;
+    }
+
+    u64 current_usage = state_ptr->buffers[state_ptr->current_buffer].allocated;
+    return current_usage > state_ptr->peak_usage ? current_usage : state_ptr->peak_usage;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "defines.h"
+
+// Scratch memory for data that only lives for a frame or two: render packets, formatted strings,
+// temporary arrays, upload staging. Allocations are carved out of one of several linear buffers;
+// at the start of every frame the next buffer in turn is reset in bulk, so nothing is freed
+// individually and no heap traffic happens per frame.
+//
+// Memory allocated during frame N stays valid until buffer_count more frames have begun. With one
+// more buffer than the renderer's frames in flight, that covers the GPU reading it as well.
+
+#define FRAME_ALLOCATOR_MAX_BUFFERS 4
+
+/**
+ * @brief Initializes the frame allocator system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size state
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory
+ * @param buffer_size The size of each buffer; the most that can be allocated in a single frame
+ * @param buffer_count The number of buffers, 2 to FRAME_ALLOCATOR_MAX_BUFFERS
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 frame_allocator_system_initialize(u64* memory_requirement, void* state, u64 buffer_size, u32 buffer_count);
+PE_API void frame_allocator_system_shutdown(void* state);
+
+/**
+ * @brief Moves on to the next buffer and resets it. Called once at the start of every frame.
+ */
+PE_API void frame_allocator_begin_frame();
+
+/**
+ * @brief Allocates a zeroed block that is valid for the rest of this frame and the next.
+ * Returns 0 if the current frame's buffer is full.
+ */
+PE_API void* frame_allocate(u64 size);
+
+// Like frame_allocate, but the block starts at a multiple of alignment (a power of two).
+PE_API void* frame_allocate_aligned(u64 size, u16 alignment);
+
+// The most memory used by any single frame so far, in bytes
+PE_API u64 frame_allocator_peak_usage();
@@ -3,10 +3,33 @@
 #include "core/pe_memory.h"
 #include "core/logger.h"
 
+// Commits enough of a virtual allocator's range for allocations to reach end
+static b8 ensure_committed(linear_allocator* allocator, u64 end) {
+    if (!allocator->is_virtual || end <= allocator->committed) {
+        return true;
+    }
+
+    u64 new_committed = pe_align_up(end, allocator->commit_granularity);
+    if (new_committed > allocator->total_size) {
+        new_committed = allocator->total_size;
+    }
+    if (!pe_memory_commit((u8*)allocator->memory + allocator->committed, new_committed - allocator->committed, allocator->huge_pages, MEMORY_TAG_LINEAR_ALLOCATOR)) {
+        PE_ERROR("linear_allocator - failed to commit memory up to %lluB.", new_committed);
+        return false;
+    }
+    allocator->committed = new_committed;
+    return true;
+}
+
 void linear_allocator_create(u64 total_size, void* memory, linear_allocator* out_allocator){
     if(out_allocator) {
         out_allocator->total_size = total_size;
         out_allocator->allocated = 0;
+        out_allocator->alignment_padding = 0;
+        out_allocator->is_virtual = false;
+        out_allocator->huge_pages = false;
+        out_allocator->committed = total_size;
+        out_allocator->commit_granularity = 0;
         out_allocator->owns_memory = memory == 0;
         if (memory) {
             out_allocator->memory = memory;
@@ -16,15 +39,55 @@ void linear_allocator_create(u64 total_size, void* memory, linear_allocator* out
     }
 }
 
+b8 linear_allocator_create_virtual(u64 reserve_size, b8 huge_pages, linear_allocator* out_allocator){
+    if (!out_allocator || reserve_size == 0) {
+        PE_ERROR("linear_allocator_create_virtual - requires a valid allocator and a size above 0.");
+        return false;
+    }
+
+    // Whole huge pages; smaller steps would leave them to be split into regular pages
+    u64 granularity = huge_pages ? pe_memory_huge_page_size() : pe_memory_page_size();
+    reserve_size = pe_align_up(reserve_size, granularity);
+
+    void* memory = pe_memory_reserve(reserve_size, huge_pages);
+    if (!memory) {
+        PE_ERROR("linear_allocator_create_virtual - failed to reserve %lluB.", reserve_size);
+        return false;
+    }
+
+    out_allocator->total_size = reserve_size;
+    out_allocator->allocated = 0;
+    out_allocator->alignment_padding = 0;
+    out_allocator->memory = memory;
+    out_allocator->owns_memory = true;
+    out_allocator->is_virtual = true;
+    out_allocator->huge_pages = huge_pages;
+    out_allocator->committed = 0;
+    out_allocator->commit_granularity = granularity;
+    return true;
+}
+
 void linear_allocator_destroy(linear_allocator* allocator){
     if(allocator) {
         allocator->allocated = 0;
+        allocator->alignment_padding = 0;
         if (allocator->owns_memory && allocator->memory) {
-            pe_free(allocator->memory, allocator->total_size, MEMORY_TAG_LINEAR_ALLOCATOR);
+            if (allocator->is_virtual) {
+                if (allocator->committed) {
+                    pe_memory_decommit(allocator->memory, allocator->committed, MEMORY_TAG_LINEAR_ALLOCATOR);
+                }
+                pe_memory_release(allocator->memory, allocator->total_size);
+            } else {
+                pe_free(allocator->memory, allocator->total_size, MEMORY_TAG_LINEAR_ALLOCATOR);
+            }
         }
         allocator->memory = 0;
         allocator->total_size = 0;
         allocator->owns_memory = false;
+        allocator->is_virtual = false;
+        allocator->huge_pages = false;
+        allocator->committed = 0;
+        allocator->commit_granularity = 0;
     }
 }
 
@@ -35,6 +98,9 @@ void* linear_allocator_allocate(linear_allocator* allocator, u64 size){
             PE_ERROR("linear_allocator_allocate - tried to allocate %lluB, only %lluB remaining.", size, remaining);
             return 0;
         }
+        if (!ensure_committed(allocator, allocator->allocated + size)) {
+            return 0;
+        }
 
         void* block = ((u8*)allocator->memory) + allocator->allocated;
         allocator->allocated += size;
@@ -45,9 +111,66 @@ void* linear_allocator_allocate(linear_allocator* allocator, u64 size){
     return 0;
 }
 
-void linear_allocator_free_all(linear_allocator* allocator){
+void* linear_allocator_allocate_aligned(linear_allocator* allocator, u64 size, u16 alignment){
+    if (allocator && allocator->memory) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            PE_ERROR("linear_allocator_allocate_aligned - alignment %u is not a power of two.", alignment);
+            return 0;
+        }
+
+        // Align the address itself, the backing memory may not be aligned as strictly
+        u64 current = (u64)allocator->memory + allocator->allocated;
+        u64 padding = pe_align_up(current, alignment) - current;
+        if (allocator->allocated + padding + size > allocator->total_size) {
+            u64 remaining = allocator->total_size - allocator->allocated;
+            PE_ERROR("linear_allocator_allocate_aligned - tried to allocate %lluB (+%lluB padding), only %lluB remaining.", size, padding, remaining);
+            return 0;
+        }
+        if (!ensure_committed(allocator, allocator->allocated + padding + size)) {
+            return 0;
+        }
+
+        void* block = ((u8*)allocator->memory) + allocator->allocated + padding;
+        allocator->allocated += padding + size;
+        allocator->alignment_padding += padding;
+        return block;
+    }
+
+    PE_ERROR("linear_allocator_allocate_aligned - provided allocator not initialized.");
+    return 0;
+}
+
+void linear_allocator_free_all(linear_allocator* allocator, b8 clear){
     if (allocator && allocator->memory) {
+        // Nothing past allocated has been handed out, so only the used bytes can need clearing
+        if (clear) {
+            pe_zero_memory(allocator->memory, allocator->allocated);
+        }
         allocator->allocated = 0;
-        pe_zero_memory(allocator->memory, allocator->total_size);
+        allocator->alignment_padding = 0;
+    }
+}
+
+linear_allocator_marker linear_allocator_get_marker(linear_allocator* allocator){
+    linear_allocator_marker marker = {0, 0};
+    if (allocator) {
+        marker.allocated = allocator->allocated;
+        marker.alignment_padding = allocator->alignment_padding;
+    }
+    return marker;
+}
+
+void linear_allocator_free_to_marker(linear_allocator* allocator, linear_allocator_marker marker, b8 clear){
+    if (allocator && allocator->memory) {
+        if (marker.allocated > allocator->allocated) {
+            PE_ERROR("linear_allocator_free_to_marker - marker at %lluB is past the current position %lluB; it was already freed.", marker.allocated, allocator->allocated);
+            return;
+        }
+
+        if (clear) {
+            pe_zero_memory((u8*)allocator->memory + marker.allocated, allocator->allocated - marker.allocated);
+        }
+        allocator->allocated = marker.allocated;
+        allocator->alignment_padding = marker.alignment_padding;
     }
 }
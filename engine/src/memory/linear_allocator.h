@@ -5,12 +5,60 @@
 typedef struct linear_allocator {
     u64 total_size;
     u64 allocated;
+    // Bytes skipped to satisfy aligned allocations; included in allocated
+    u64 alignment_padding;
     void* memory;
     b8 owns_memory;
+    // Virtual allocators reserve total_size of address space and commit it as allocations reach it
+    b8 is_virtual;
+    b8 huge_pages;
+    u64 committed;
+    u64 commit_granularity;
 } linear_allocator;
 
+// A point in a linear allocator's allocations to roll back to, which lets it be used as a stack
+typedef struct linear_allocator_marker {
+    u64 allocated;
+    u64 alignment_padding;
+} linear_allocator_marker;
+
 PE_API void linear_allocator_create(u64 total_size, void* memory, linear_allocator* out_allocator);
+
+/**
+ * @brief Creates a linear allocator over a reserved range of address space. Memory is committed
+ * in steps as allocations reach it, so a generous size costs address space, not resident memory.
+ * Committed memory is kept until the allocator is destroyed.
+ *
+ * @param reserve_size The most the allocator can ever hold. Rounded up to the commit granularity.
+ * @param huge_pages Back the committed memory with huge pages, committing a whole huge page at a time
+ * @param out_allocator A pointer to hold the allocator
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 linear_allocator_create_virtual(u64 reserve_size, b8 huge_pages, linear_allocator* out_allocator);
 PE_API void linear_allocator_destroy(linear_allocator* allocator);
 
 PE_API void* linear_allocator_allocate(linear_allocator* allocator, u64 size);
-PE_API void linear_allocator_free_all(linear_allocator* allocator);
\ No newline at end of file
+
+// Like linear_allocator_allocate, but pads the block start to a multiple of alignment (a power of two).
+PE_API void* linear_allocator_allocate_aligned(linear_allocator* allocator, u64 size, u16 alignment);
+
+/**
+ * @brief Frees every allocation at once.
+ *
+ * @param allocator The allocator to reset
+ * @param clear Zero the bytes that were in use, so later allocations start out zeroed
+ */
+PE_API void linear_allocator_free_all(linear_allocator* allocator, b8 clear);
+
+// Returns a marker for the allocator's current position.
+PE_API linear_allocator_marker linear_allocator_get_marker(linear_allocator* allocator);
+
+/**
+ * @brief Frees everything allocated after the marker was taken, in O(1). Markers taken
+ * after this one become invalid.
+ *
+ * @param allocator The allocator the marker was taken from
+ * @param marker The position to roll back to
+ * @param clear Zero the bytes being freed
+ */
+PE_API void linear_allocator_free_to_marker(linear_allocator* allocator, linear_allocator_marker marker, b8 clear);
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "pool_allocator.h"
+
+#include "core/logger.h"
+
+// Stored at the start of every chunk
+typedef struct pool_chunk_header {
+    struct pool_chunk_header* next;
+} pool_chunk_header;
+
+// Offset of the first block in a chunk
+PE_INLINE u64 chunk_elements_offset(pool_allocator* allocator) {
+    return pe_align_up(sizeof(pool_chunk_header), allocator->element_alignment);
+}
+
+static b8 pool_add_chunk(pool_allocator* allocator) {
+    pool_chunk_header* chunk = pe_allocate_pages(allocator->chunk_size, false, allocator->tag);
+    if (!chunk) {
+        PE_ERROR("Pool '%s' failed to allocate a chunk of %lluB.", allocator->name, allocator->chunk_size);
+        return false;
+    }
+
+    chunk->next = allocator->chunks;
+    allocator->chunks = chunk;
+    allocator->chunk_count++;
+    allocator->capacity += allocator->elements_per_chunk;
+
+    // Blocks are handed out in order from here, so untouched pages are never faulted in early
+    allocator->next_unused = (u8*)chunk + chunk_elements_offset(allocator);
+    allocator->chunk_end = allocator->next_unused + allocator->elements_per_chunk * allocator->element_size;
+    return true;
+}
+
+b8 pool_allocator_create(const char* name, u64 element_size, u64 element_count, b8 can_grow, memory_tag tag, pool_allocator* out_allocator) {
+    if (!out_allocator || element_size == 0 || element_count == 0) {
+        PE_ERROR("pool_allocator_create - requires a valid allocator, element size and element count.");
+        return false;
+    }
+
+    pe_zero_memory(out_allocator, sizeof(pool_allocator));
+    out_allocator->name = name ? name : "unnamed";
+    out_allocator->tag = tag;
+    out_allocator->can_grow = can_grow;
+
+    // Free blocks hold the free list link, and blocks of 16 bytes or more may hold SIMD types
+    out_allocator->element_alignment = element_size >= 16 ? 16 : sizeof(void*);
+    out_allocator->element_size = pe_align_up(element_size, out_allocator->element_alignment);
+
+    u64 page_size = pe_memory_page_size();
+    u64 elements_offset = chunk_elements_offset(out_allocator);
+    out_allocator->chunk_size = pe_align_up(elements_offset + element_count * out_allocator->element_size, page_size);
+    out_allocator->elements_per_chunk = (out_allocator->chunk_size - elements_offset) / out_allocator->element_size;
+
+    if (!pool_add_chunk(out_allocator)) {
+        return false;
+    }
+
+    memory_system_register_pool(out_allocator);
+    return true;
+}
+
+void pool_allocator_destroy(pool_allocator* allocator) {
+    if (!allocator || !allocator->chunks) {
+        return;
+    }
+
+    if (allocator->live_count > 0) {
+        PE_WARN("Pool '%s' destroyed with %llu blocks still in use.", allocator->name, allocator->live_count);
+    }
+
+    memory_system_unregister_pool(allocator);
+
+    pool_chunk_header* chunk = allocator->chunks;
+    while (chunk) {
+        pool_chunk_header* next = chunk->next;
+        pe_free_pages(chunk, allocator->chunk_size, false, allocator->tag);
+        chunk = next;
+    }
+
+    pe_zero_memory(allocator, sizeof(pool_allocator));
+}
+
+void* pool_allocator_allocate(pool_allocator* allocator) {
+    if (!allocator || !allocator->chunks) {
+        PE_ERROR("pool_allocator_allocate - provided allocator not initialized.");
+        return 0;
+    }
+
+    void* block = allocator->free_list;
+    if (block) {
+        allocator->free_list = *(void**)block;
+    } else {
+        if (allocator->next_unused == allocator->chunk_end) {
+            if (!allocator->can_grow) {
+                PE_ERROR("Pool '%s' is full (%llu blocks) and cannot grow.", allocator->name, allocator->capacity);
+                return 0;
+            }
+            if (!pool_add_chunk(allocator)) {
+                return 0;
+            }
+        }
+        block = allocator->next_unused;
+        allocator->next_unused += allocator->element_size;
+    }
+
+    allocator->live_count++;
+    if (allocator->live_count > allocator->peak_count) {
+        allocator->peak_count = allocator->live_count;
+    }
+    return block;
+}
+
+void pool_allocator_free(pool_allocator* allocator, void* block) {
+    if (!allocator || !block) {
+        return;
+    }
+
+#if defined(_DEBUG)
+    if (!pool_allocator_owns(allocator, block)) {
+        PE_ERROR("pool_allocator_free - block %p does not belong to pool '%s'.", block, allocator->name);
+        return;
+    }
+#endif
+
+    *(void**)block = allocator->free_list;
+    allocator->free_list = block;
+    allocator->live_count--;
+}
+
+b8 pool_allocator_owns(pool_allocator* allocator, const void* block) {
+    if (!allocator) {
+        return false;
+    }
+
+    u64 elements_offset = chunk_elements_offset(allocator);
+    for (pool_chunk_header* chunk = allocator->chunks; chunk; chunk = chunk->next) {
+        const u8* first = (const u8*)chunk + elements_offset;
+        const u8* end = first + allocator->elements_per_chunk * allocator->element_size;
+        if ((const u8*)block >= first && (const u8*)block < end) {
+            return ((const u8*)block - first) % allocator->element_size == 0;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "defines.h"
+#include "core/pe_memory.h"
+
+// Fixed-size block allocator for objects that are created and destroyed often.
+// Allocation and free are O(1): freed blocks are kept in a free list threaded through
+// the blocks themselves, and reused most-recently-freed first so live objects stay packed
+// in memory that is already warm. Blocks live in chunks of whole pages taken straight from
+// the OS; a pool can optionally grow by adding chunks. Not thread safe.
+typedef struct pool_allocator {
+    const char* name;
+    memory_tag tag;
+    // Block size, rounded up to the block alignment
+    u64 element_size;
+    u64 element_alignment;
+    // Every chunk is the same size and holds the same number of blocks
+    u64 chunk_size;
+    u64 elements_per_chunk;
+    u32 chunk_count;
+    b8 can_grow;
+    // Most recent chunk first
+    void* chunks;
+    // Blocks of the newest chunk that have never been handed out start here
+    u8* next_unused;
+    u8* chunk_end;
+    void* free_list;
+
+    // Occupancy, in blocks
+    u64 capacity;
+    u64 live_count;
+    u64 peak_count;
+} pool_allocator;
+
+/**
+ * @brief Creates a pool allocator and allocates its first chunk.
+ *
+ * @param name Name reported in the memory usage stats. Must outlive the pool.
+ * @param element_size The size of each block in bytes
+ * @param element_count Blocks per chunk. Rounded up to fill whole pages.
+ * @param can_grow Add chunks when full instead of failing allocations
+ * @param tag The memory tag the chunks are accounted under
+ * @param out_allocator A pointer to hold the allocator
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 pool_allocator_create(const char* name, u64 element_size, u64 element_count, b8 can_grow, memory_tag tag, pool_allocator* out_allocator);
+PE_API void pool_allocator_destroy(pool_allocator* allocator);
+
+// Returns a block of element_size bytes with undefined contents, or 0 if the pool is full and cannot grow.
+PE_API void* pool_allocator_allocate(pool_allocator* allocator);
+PE_API void pool_allocator_free(pool_allocator* allocator, void* block);
+
+// True if block lies within one of the pool's chunks.
+PE_API b8 pool_allocator_owns(pool_allocator* allocator, const void* block);
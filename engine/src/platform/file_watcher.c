@@ -0,0 +1,307 @@
+#include "file_watcher.h"
+
+#include "core/logger.h"
+#include "core/event.h"
+#include "core/pe_string.h"
+#include "platform/platform.h"
+
+#include <string.h>
+
+#if PE_PLATFORM_WINDOWS
+#include <windows.h>
+#elif PE_PLATFORM_LINUX
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+// How long a file has to stay untouched before its change is reported
+#define COALESCE_WINDOW_SECONDS 0.1
+
+#define MAX_PENDING_CHANGES 64
+#define MAX_FILE_NAME_LENGTH 256
+
+typedef struct pending_change {
+    b8 in_use;
+    u32 watch_id;
+    f64 last_change_time;
+    char file_name[MAX_FILE_NAME_LENGTH];
+} pending_change;
+
+typedef struct watch_entry {
+    b8 in_use;
+#if PE_PLATFORM_WINDOWS
+    HANDLE directory;
+    OVERLAPPED overlapped;
+    // FILE_NOTIFY_INFORMATION records need DWORD alignment
+    DWORD buffer[1024];
+#elif PE_PLATFORM_LINUX
+    i32 descriptor;
+#endif
+} watch_entry;
+
+typedef struct file_watcher_state {
+#if PE_PLATFORM_LINUX
+    i32 inotify_fd;
+#endif
+    watch_entry watches[FILE_WATCHER_MAX_WATCHES];
+    pending_change pending[MAX_PENDING_CHANGES];
+} file_watcher_state;
+
+static file_watcher_state* state_ptr;
+
+static void fire_change(u32 watch_id, const char* file_name) {
+    event_context context;
+    context.data.u32[0] = watch_id;
+    context.data.u64[1] = (u64)file_name;
+    event_fire(EVENT_CODE_FILE_CHANGED, 0, context);
+}
+
+// Records a change, restarting the quiet window if the file already has one pending.
+static void record_change(u32 watch_id, const char* file_name, f64 now) {
+    pending_change* free_slot = 0;
+    for (u32 i = 0; i < MAX_PENDING_CHANGES; ++i) {
+        pending_change* change = &state_ptr->pending[i];
+        if (!change->in_use) {
+            if (!free_slot) {
+                free_slot = change;
+            }
+            continue;
+        }
+        if (change->watch_id == watch_id && strings_equal(change->file_name, file_name)) {
+            change->last_change_time = now;
+            return;
+        }
+    }
+
+    if (!free_slot) {
+        // Too many files changing at once to coalesce; report right away
+        fire_change(watch_id, file_name);
+        return;
+    }
+
+    free_slot->in_use = true;
+    free_slot->watch_id = watch_id;
+    free_slot->last_change_time = now;
+    strncpy(free_slot->file_name, file_name, MAX_FILE_NAME_LENGTH - 1);
+    free_slot->file_name[MAX_FILE_NAME_LENGTH - 1] = 0;
+}
+
+#if PE_PLATFORM_WINDOWS
+static b8 watch_issue_read(watch_entry* watch) {
+    // Returns right away; completion is polled in file_watcher_update
+    return ReadDirectoryChangesW(
+        watch->directory,
+        watch->buffer,
+        sizeof(watch->buffer),
+        FALSE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+        0,
+        &watch->overlapped,
+        0);
+}
+#endif
+
+b8 file_watcher_system_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(file_watcher_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    platform_zero_memory(state_ptr, sizeof(file_watcher_state));
+
+#if PE_PLATFORM_LINUX
+    state_ptr->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (state_ptr->inotify_fd < 0) {
+        PE_ERROR("Failed to initialize inotify (errno %i).", errno);
+        state_ptr = 0;
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+void file_watcher_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    for (u32 i = 0; i < FILE_WATCHER_MAX_WATCHES; ++i) {
+        file_watcher_unwatch(i);
+    }
+
+#if PE_PLATFORM_LINUX
+    close(state_ptr->inotify_fd);
+#endif
+
+    state_ptr = 0;
+}
+
+b8 file_watcher_watch_directory(const char* directory_path, u32* out_watch_id) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    for (u32 i = 0; i < FILE_WATCHER_MAX_WATCHES; ++i) {
+        watch_entry* watch = &state_ptr->watches[i];
+        if (watch->in_use) {
+            continue;
+        }
+
+#if PE_PLATFORM_WINDOWS
+        watch->directory = CreateFileA(
+            directory_path,
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            0,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            0);
+        if (watch->directory == INVALID_HANDLE_VALUE) {
+            PE_ERROR("Failed to watch directory '%s'.", directory_path);
+            return false;
+        }
+        platform_zero_memory(&watch->overlapped, sizeof(OVERLAPPED));
+        watch->overlapped.hEvent = CreateEventA(0, TRUE, FALSE, 0);
+        if (!watch_issue_read(watch)) {
+            PE_ERROR("Failed to watch directory '%s'.", directory_path);
+            CloseHandle(watch->overlapped.hEvent);
+            CloseHandle(watch->directory);
+            return false;
+        }
+#elif PE_PLATFORM_LINUX
+        // Writes in place end with CLOSE_WRITE, atomic saves end with MOVED_TO
+        watch->descriptor = inotify_add_watch(state_ptr->inotify_fd, directory_path, IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch->descriptor < 0) {
+            PE_ERROR("Failed to watch directory '%s' (errno %i).", directory_path, errno);
+            return false;
+        }
+#endif
+
+        watch->in_use = true;
+        *out_watch_id = i;
+        PE_DEBUG("Watching directory '%s' for changes.", directory_path);
+        return true;
+    }
+
+    PE_ERROR("Failed to watch directory '%s', all %u watches are in use.", directory_path, FILE_WATCHER_MAX_WATCHES);
+    return false;
+}
+
+void file_watcher_unwatch(u32 watch_id) {
+    if (!state_ptr || watch_id >= FILE_WATCHER_MAX_WATCHES || !state_ptr->watches[watch_id].in_use) {
+        return;
+    }
+
+    watch_entry* watch = &state_ptr->watches[watch_id];
+#if PE_PLATFORM_WINDOWS
+    CancelIoEx(watch->directory, &watch->overlapped);
+    // The buffer must not be released before the cancelled read completes
+    DWORD bytes;
+    GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, TRUE);
+    CloseHandle(watch->overlapped.hEvent);
+    CloseHandle(watch->directory);
+#elif PE_PLATFORM_LINUX
+    inotify_rm_watch(state_ptr->inotify_fd, watch->descriptor);
+#endif
+    watch->in_use = false;
+
+    for (u32 i = 0; i < MAX_PENDING_CHANGES; ++i) {
+        if (state_ptr->pending[i].in_use && state_ptr->pending[i].watch_id == watch_id) {
+            state_ptr->pending[i].in_use = false;
+        }
+    }
+}
+
+void file_watcher_update() {
+    if (!state_ptr) {
+        return;
+    }
+
+    f64 now = platform_get_absolute_time();
+
+#if PE_PLATFORM_WINDOWS
+    for (u32 i = 0; i < FILE_WATCHER_MAX_WATCHES; ++i) {
+        watch_entry* watch = &state_ptr->watches[i];
+        if (!watch->in_use) {
+            continue;
+        }
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, FALSE)) {
+            // ERROR_IO_INCOMPLETE: nothing changed yet
+            continue;
+        }
+
+        // 0 bytes means the buffer overflowed and the changes were lost
+        if (bytes == 0) {
+            PE_WARN("File watcher buffer overflowed; some changes were missed.");
+        }
+
+        u8* record = (u8*)watch->buffer;
+        while (bytes > 0) {
+            FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*)record;
+            if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                char file_name[MAX_FILE_NAME_LENGTH];
+                i32 length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, info->FileNameLength / sizeof(WCHAR), file_name, MAX_FILE_NAME_LENGTH - 1, 0, 0);
+                file_name[length > 0 ? length : 0] = 0;
+                record_change(i, file_name, now);
+            }
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            record += info->NextEntryOffset;
+        }
+
+        ResetEvent(watch->overlapped.hEvent);
+        if (!watch_issue_read(watch)) {
+            PE_ERROR("Failed to keep watching directory; changes will no longer be reported.");
+            file_watcher_unwatch(i);
+        }
+    }
+#elif PE_PLATFORM_LINUX
+    u8 buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (true) {
+        ssize_t length = read(state_ptr->inotify_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: drained
+            break;
+        }
+
+        for (u8* cursor = buffer; cursor < buffer + length;) {
+            struct inotify_event* event = (struct inotify_event*)cursor;
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                PE_WARN("File watcher queue overflowed; some changes were missed.");
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            for (u32 i = 0; i < FILE_WATCHER_MAX_WATCHES; ++i) {
+                if (state_ptr->watches[i].in_use && state_ptr->watches[i].descriptor == event->wd) {
+                    record_change(i, event->name, now);
+                    break;
+                }
+            }
+        }
+    }
+#endif
+
+    // Report the files that have settled
+    for (u32 i = 0; i < MAX_PENDING_CHANGES; ++i) {
+        pending_change* change = &state_ptr->pending[i];
+        if (change->in_use && now - change->last_change_time >= COALESCE_WINDOW_SECONDS) {
+            // Free the slot first, so listeners can cause new changes to be recorded
+            char file_name[MAX_FILE_NAME_LENGTH];
+            strncpy(file_name, change->file_name, MAX_FILE_NAME_LENGTH - 1);
+            file_name[MAX_FILE_NAME_LENGTH - 1] = 0;
+            change->in_use = false;
+            fire_change(change->watch_id, file_name);
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "defines.h"
+
+// Directory change notifications from the OS (inotify on Linux, ReadDirectoryChangesW on Windows).
+// Changes are drained once per frame without blocking. Bursts of changes to the same file (editors
+// often write a file several times per save) are coalesced, and reported once the file has been
+// quiet for a short window, as an EVENT_CODE_FILE_CHANGED event.
+
+#define FILE_WATCHER_MAX_WATCHES 16
+
+/**
+ * @brief Initializes the file watcher system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size state
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 file_watcher_system_initialize(u64* memory_requirement, void* state);
+PE_API void file_watcher_system_shutdown(void* state);
+
+/**
+ * @brief Starts watching the files directly inside the given directory (not recursive)
+ * for being written, created or renamed into place.
+ *
+ * @param directory_path The path of the directory to watch
+ * @param out_watch_id A pointer to hold the id reported with change events for this directory
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 file_watcher_watch_directory(const char* directory_path, u32* out_watch_id);
+
+/**
+ * @brief Stops watching the directory with the given id.
+ */
+PE_API void file_watcher_unwatch(u32 watch_id);
+
+/**
+ * @brief Drains pending OS notifications and fires events for changes that have settled.
+ * Called once per frame.
+ */
+PE_API void file_watcher_update();
@@ -8,9 +8,22 @@
 #include <string.h>
 #include <sys/stat.h>
 
+#if PE_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
 PE_API b8 filesystem_exists(const char* path){
+#ifdef _MSC_VER
     struct _stat buffer;
     return _stat(path, &buffer) == 0;
+#else
+    struct stat buffer;
+    return stat(path, &buffer) == 0;
+#endif
 }
 
 PE_API b8 filesystem_open(const char* path, file_modes mode, b8 binary, file_handle* out_handle){
@@ -56,7 +69,7 @@ PE_API b8 filesystem_read_line(file_handle* handle, char** line_buf){
         char buffer[32000];
         if (fgets(buffer, 32000, (FILE*)handle->handle) != 0) {
             u64 length = strlen(buffer);
-            *line_buf = pe_allocate((sizeof(char) * length) + 1, MEMORY_TAG_STRING);
+            *line_buf = pe_allocate_uninit((sizeof(char) * length) + 1, MEMORY_TAG_STRING);
             strcpy(*line_buf, buffer);
             return true;
         }
@@ -97,7 +110,8 @@ PE_API b8 filesystem_read_all_bytes(file_handle* handle, u8** out_bytes, u64* ou
         u64 size = ftell((FILE*)handle->handle);
         rewind((FILE*)handle->handle);
 
-        *out_bytes = pe_allocate(sizeof(u8) * size, MEMORY_TAG_STRING);
+        // Filled by the read right away
+        *out_bytes = pe_allocate_uninit(sizeof(u8) * size, MEMORY_TAG_STRING);
         *out_bytes_read = fread(*out_bytes, 1, size, (FILE*)handle->handle);
         
         return *out_bytes_read == size;
@@ -108,11 +122,112 @@ PE_API b8 filesystem_read_all_bytes(file_handle* handle, u8** out_bytes, u64* ou
 PE_API b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written){
     if (handle->handle) {
         *out_bytes_written = fwrite(data, 1, data_size, (FILE*)handle->handle);
-        if (*out_bytes_written != data_size) {
-            return false;
-        }
-        fflush((FILE*)handle->handle);
-        return true;
+        return *out_bytes_written == data_size;
+    }
+    return false;
+}
+
+PE_API b8 filesystem_flush(file_handle* handle){
+    if (handle->handle) {
+        return fflush((FILE*)handle->handle) == 0;
     }
     return false;
-}
\ No newline at end of file
+}
+
+PE_API b8 filesystem_map(const char* path, u32 hints, file_mapping* out_mapping){
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+
+#if PE_PLATFORM_WINDOWS
+    DWORD flags = (hints & FILE_MAP_HINT_SEQUENTIAL) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, flags, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        PE_ERROR("Error opening file '%s' for mapping.", path);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        PE_ERROR("Error reading size of file '%s'.", path);
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    // The view keeps the mapping and the file alive, so both handles can be closed right away
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping) {
+        PE_ERROR("Error mapping file '%s'.", path);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) {
+        PE_ERROR("Error mapping file '%s'.", path);
+        return false;
+    }
+
+    if (hints & FILE_MAP_HINT_WILLNEED) {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = data;
+        range.NumberOfBytes = (SIZE_T)size.QuadPart;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    out_mapping->data = data;
+    out_mapping->size = (u64)size.QuadPart;
+    return true;
+#else
+    i32 fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        PE_ERROR("Error opening file '%s' for mapping.", path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        PE_ERROR("Error reading size of file '%s'.", path);
+        close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping holds its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        PE_ERROR("Error mapping file '%s'.", path);
+        return false;
+    }
+
+    if (hints & FILE_MAP_HINT_SEQUENTIAL) {
+        madvise(data, info.st_size, MADV_SEQUENTIAL);
+    }
+    if (hints & FILE_MAP_HINT_WILLNEED) {
+        madvise(data, info.st_size, MADV_WILLNEED);
+    }
+
+    out_mapping->data = data;
+    out_mapping->size = (u64)info.st_size;
+    return true;
+#endif
+}
+
+PE_API void filesystem_unmap(file_mapping* mapping){
+    if (mapping->data) {
+#if PE_PLATFORM_WINDOWS
+        UnmapViewOfFile(mapping->data);
+#else
+        munmap((void*)mapping->data, mapping->size);
+#endif
+    }
+    mapping->data = 0;
+    mapping->size = 0;
+}
@@ -88,4 +88,141 @@ PE_API b8 filesystem_read_all_bytes(file_handle* handle, u8** out_bytes, u64* ou
  * @param out_bytes_written A pointer to a number which will be populated with
  * the number of bytes actually written to the file
  */
-PE_API b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written);
\ No newline at end of file
+PE_API b8 filesystem_write(file_handle* handle, u64 data_size, const void* data, u64* out_bytes_written);
+
+// Read-only view of a whole file, mapped into the address space
+typedef struct file_mapping {
+    const void* data;
+    u64 size;
+} file_mapping;
+
+typedef enum file_map_hints {
+    FILE_MAP_HINT_NONE = 0x0,
+    // The mapping will be read front to back; enables aggressive readahead
+    FILE_MAP_HINT_SEQUENTIAL = 0x1,
+    // Start reading the whole file in now, ahead of the first access
+    FILE_MAP_HINT_WILLNEED = 0x2
+} file_map_hints;
+
+/**
+ * @brief Maps the file located at path read-only, so it can be parsed in place without copying
+ * it to the heap. Pages are loaded on first access. An empty file maps to data = 0, size = 0.
+ * 
+ * @param path The path of the file to be mapped
+ * @param hints file_map_hints flags describing the expected access pattern
+ * @param out_mapping A pointer to a file_mapping structure, which holds the mapped view
+ * @returns True if mapped successfully; otherwise false.
+ */
+PE_API b8 filesystem_map(const char* path, u32 hints, file_mapping* out_mapping);
+
+/**
+ * @brief Unmaps a view created with filesystem_map. Any pointers into the data become invalid.
+ * 
+ * @param mapping A pointer to the file_mapping to be unmapped
+ */
+PE_API void filesystem_unmap(file_mapping* mapping);
+
+/**
+ * @brief Flushes buffered writes of the provided file to the OS.
+ * 
+ * @param handle A pointer to file_handle structure
+ * @returns True if successful; otherwise false.
+ */
+PE_API b8 filesystem_flush(file_handle* handle);
+
+// Asynchronous I/O
+// Requests go through io_uring on Linux when the kernel supports it, and through a pool of
+// worker threads issuing positioned reads/writes otherwise. Async requests address the file
+// by offset and bypass the stdio buffer of the handle, so don't mix them with the buffered
+// calls above on the same handle.
+
+typedef enum file_io_status {
+    FILE_IO_STATUS_PENDING,
+    FILE_IO_STATUS_COMPLETE,
+    FILE_IO_STATUS_FAILED
+} file_io_status;
+
+struct file_io_request;
+
+// Called on the main thread from filesystem_async_update once the request finishes.
+typedef void (*pfn_file_io_callback)(struct file_io_request* request);
+
+typedef struct file_io_request {
+    // Filled in by the caller
+    file_handle* handle;
+    u64 offset;
+    u64 size;
+    // Destination for reads, source for writes. Must stay valid until the request finishes.
+    void* buffer;
+    // Optional. Without a callback, poll or wait on the request instead.
+    pfn_file_io_callback callback;
+    void* user_data;
+
+    // Filled in by the I/O system. status is written last.
+    volatile u32 status;
+    // Less than size when a read hits the end of the file.
+    u64 bytes_transferred;
+
+    // Internal
+    u32 operation;
+    struct file_io_request* next;
+} file_io_request;
+
+/**
+ * @brief Initializes the async I/O system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ * 
+ * @param memory_requirement A pointer to hold the required memory size state
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory
+ * @param queue_depth The maximum number of requests submitted to the kernel at once. 0 skips io_uring
+ * and always uses worker threads.
+ * @param worker_count The number of threads used when io_uring is unavailable
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 filesystem_async_system_initialize(u64* memory_requirement, void* state, u32 queue_depth, u32 worker_count);
+PE_API void filesystem_async_system_shutdown(void* state);
+
+/**
+ * @brief Queues a read of request->size bytes at request->offset into request->buffer.
+ * Queued requests are handed to the OS by filesystem_async_submit or filesystem_async_update.
+ * The request must stay valid until it finishes and its callback (if any) has run.
+ * 
+ * @param request A pointer to a filled in file_io_request
+ * @returns True if queued; otherwise false.
+ */
+PE_API b8 filesystem_read_async(file_io_request* request);
+
+/**
+ * @brief Queues a write of request->size bytes from request->buffer at request->offset.
+ * Same rules as filesystem_read_async.
+ * 
+ * @param request A pointer to a filled in file_io_request
+ * @returns True if queued; otherwise false.
+ */
+PE_API b8 filesystem_write_async(file_io_request* request);
+
+/**
+ * @brief Hands all queued requests to the OS in one batch.
+ */
+PE_API void filesystem_async_submit();
+
+/**
+ * @brief Checks if the request has finished, without blocking.
+ * 
+ * @param request A pointer to a queued file_io_request
+ * @returns True if the request completed or failed; otherwise false.
+ */
+PE_API b8 filesystem_async_poll(file_io_request* request);
+
+/**
+ * @brief Blocks until the request finishes.
+ * 
+ * @param request A pointer to a queued file_io_request
+ * @returns True if the request completed successfully; otherwise false.
+ */
+PE_API b8 filesystem_async_wait(file_io_request* request);
+
+/**
+ * @brief Submits queued requests and runs the callbacks of finished ones. Called once per frame.
+ */
+PE_API void filesystem_async_update();
@@ -0,0 +1,583 @@
+#include "filesystem.h"
+
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <stdio.h>
+
+#if PE_PLATFORM_WINDOWS
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#if PE_PLATFORM_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+typedef enum file_io_operation {
+    FILE_IO_OPERATION_READ,
+    FILE_IO_OPERATION_WRITE
+} file_io_operation;
+
+// Intrusive FIFO of requests, linked through file_io_request::next
+typedef struct file_io_list {
+    file_io_request* head;
+    file_io_request* tail;
+} file_io_list;
+
+#if PE_PLATFORM_LINUX
+typedef struct io_uring_ring {
+    i32 fd;
+
+    u32* sq_head;
+    u32* sq_tail;
+    u32* sq_array;
+    u32 sq_mask;
+    u32 sq_entries;
+    struct io_uring_sqe* sqes;
+
+    u32* cq_head;
+    u32* cq_tail;
+    u32 cq_mask;
+    u32 cq_entries;
+    struct io_uring_cqe* cqes;
+
+    void* sq_ring_ptr;
+    u64 sq_ring_size;
+    void* cq_ring_ptr;
+    u64 cq_ring_size;
+    u64 sqes_size;
+
+    // Queued in the SQ but not yet handed to the kernel
+    u32 unsubmitted;
+    // Submitted or queued, without a reaped completion
+    u32 in_flight;
+} io_uring_ring;
+#endif
+
+typedef struct filesystem_async_state {
+    b8 use_io_uring;
+#if PE_PLATFORM_LINUX
+    io_uring_ring ring;
+#endif
+
+    // Thread pool fallback
+    b8 running;
+    u32 worker_count;
+    platform_thread* workers;
+    platform_mutex queue_mutex;
+    platform_condvar queue_condvar;
+    // Queued by the main thread, not yet visible to the workers
+    file_io_list queued;
+    // Picked up by the workers
+    file_io_list pending;
+    platform_mutex completed_mutex;
+    platform_condvar completed_condvar;
+
+    // Finished requests with a callback, waiting for filesystem_async_update
+    file_io_list completed;
+} filesystem_async_state;
+
+static filesystem_async_state* state_ptr;
+
+static void list_push(file_io_list* list, file_io_request* request) {
+    request->next = 0;
+    if (list->tail) {
+        list->tail->next = request;
+    } else {
+        list->head = request;
+    }
+    list->tail = request;
+}
+
+static file_io_request* list_pop(file_io_list* list) {
+    file_io_request* request = list->head;
+    if (request) {
+        list->head = request->next;
+        if (!list->head) {
+            list->tail = 0;
+        }
+        request->next = 0;
+    }
+    return request;
+}
+
+static void list_append(file_io_list* list, file_io_list* other) {
+    if (!other->head) {
+        return;
+    }
+    if (list->tail) {
+        list->tail->next = other->head;
+    } else {
+        list->head = other->head;
+    }
+    list->tail = other->tail;
+    other->head = 0;
+    other->tail = 0;
+}
+
+// Positioned I/O, shared by the worker threads. Returns the number of bytes transferred, or -1 on error.
+static i64 file_io_perform(file_io_request* request) {
+    FILE* file = (FILE*)request->handle->handle;
+    u8* buffer = request->buffer;
+    u64 done = 0;
+
+#if PE_PLATFORM_WINDOWS
+    HANDLE os_handle = (HANDLE)_get_osfhandle(_fileno(file));
+    while (done < request->size) {
+        u64 offset = request->offset + done;
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = (DWORD)(offset & 0xffffffff);
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        u64 remaining = request->size - done;
+        DWORD chunk = remaining > 0x40000000 ? 0x40000000 : (DWORD)remaining;
+        DWORD transferred = 0;
+        BOOL result = request->operation == FILE_IO_OPERATION_READ
+            ? ReadFile(os_handle, buffer + done, chunk, &transferred, &overlapped)
+            : WriteFile(os_handle, buffer + done, chunk, &transferred, &overlapped);
+        if (!result) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            return -1;
+        }
+        if (transferred == 0) {
+            break;
+        }
+        done += transferred;
+    }
+#else
+    i32 fd = fileno(file);
+    while (done < request->size) {
+        ssize_t result = request->operation == FILE_IO_OPERATION_READ
+            ? pread(fd, buffer + done, request->size - done, request->offset + done)
+            : pwrite(fd, buffer + done, request->size - done, request->offset + done);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (result == 0) {
+            // End of file
+            break;
+        }
+        done += result;
+    }
+#endif
+
+    return (i64)done;
+}
+
+static u32 file_io_worker_run(void* params) {
+    while (true) {
+        platform_mutex_lock(&state_ptr->queue_mutex);
+        while (state_ptr->running && !state_ptr->pending.head) {
+            platform_condvar_wait(&state_ptr->queue_condvar, &state_ptr->queue_mutex);
+        }
+        file_io_request* request = list_pop(&state_ptr->pending);
+        platform_mutex_unlock(&state_ptr->queue_mutex);
+
+        if (!request) {
+            // Shutting down with nothing left to do
+            break;
+        }
+
+        i64 result = file_io_perform(request);
+        request->bytes_transferred = result < 0 ? 0 : (u64)result;
+
+        platform_mutex_lock(&state_ptr->completed_mutex);
+        if (request->callback) {
+            list_push(&state_ptr->completed, request);
+        }
+        PE_ATOMIC_STORE(&request->status, result < 0 ? FILE_IO_STATUS_FAILED : FILE_IO_STATUS_COMPLETE, PE_ATOMIC_RELEASE);
+        platform_condvar_broadcast(&state_ptr->completed_condvar);
+        platform_mutex_unlock(&state_ptr->completed_mutex);
+    }
+    return 0;
+}
+
+#if PE_PLATFORM_LINUX
+
+static i32 io_uring_setup(u32 entries, struct io_uring_params* params) {
+    return (i32)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static i32 io_uring_enter(i32 fd, u32 to_submit, u32 min_complete, u32 flags) {
+    return (i32)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, 0, 0);
+}
+
+static b8 ring_create(u32 queue_depth, io_uring_ring* ring) {
+    struct io_uring_params params;
+    platform_zero_memory(&params, sizeof(params));
+
+    ring->fd = io_uring_setup(queue_depth, &params);
+    if (ring->fd < 0) {
+        // ENOSYS on old kernels, EPERM when disabled by sysctl or a seccomp filter
+        PE_INFO("io_uring unavailable (errno %i), using worker threads for async I/O.", errno);
+        return false;
+    }
+
+    // IORING_OP_READ/WRITE need 5.6; FAST_POLL is the closest feature bit (5.7)
+    if (!(params.features & IORING_FEAT_FAST_POLL)) {
+        PE_INFO("io_uring is too old for plain read/write ops, using worker threads for async I/O.");
+        close(ring->fd);
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    b8 single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        if (ring->cq_ring_size > ring->sq_ring_size) {
+            ring->sq_ring_size = ring->cq_ring_size;
+        }
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring_ptr = mmap(0, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring_ptr == MAP_FAILED) {
+        PE_ERROR("Failed to map the io_uring submission ring.");
+        close(ring->fd);
+        return false;
+    }
+
+    if (single_mmap) {
+        ring->cq_ring_ptr = ring->sq_ring_ptr;
+    } else {
+        ring->cq_ring_ptr = mmap(0, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring_ptr == MAP_FAILED) {
+            PE_ERROR("Failed to map the io_uring completion ring.");
+            munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+            close(ring->fd);
+            return false;
+        }
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(0, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        PE_ERROR("Failed to map the io_uring submission entries.");
+        if (!single_mmap) {
+            munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+        }
+        munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+        close(ring->fd);
+        return false;
+    }
+
+    u8* sq = ring->sq_ring_ptr;
+    ring->sq_head = (u32*)(sq + params.sq_off.head);
+    ring->sq_tail = (u32*)(sq + params.sq_off.tail);
+    ring->sq_mask = *(u32*)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = *(u32*)(sq + params.sq_off.ring_entries);
+    ring->sq_array = (u32*)(sq + params.sq_off.array);
+
+    u8* cq = ring->cq_ring_ptr;
+    ring->cq_head = (u32*)(cq + params.cq_off.head);
+    ring->cq_tail = (u32*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(u32*)(cq + params.cq_off.ring_mask);
+    ring->cq_entries = *(u32*)(cq + params.cq_off.ring_entries);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    ring->unsubmitted = 0;
+    ring->in_flight = 0;
+
+    PE_INFO("Async I/O using io_uring (%u submission entries).", ring->sq_entries);
+    return true;
+}
+
+static void ring_destroy(io_uring_ring* ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring_ptr != ring->sq_ring_ptr) {
+        munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+// Hands queued entries to the kernel, optionally waiting for at least min_complete completions.
+static void ring_submit(io_uring_ring* ring, u32 min_complete) {
+    u32 flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    while (ring->unsubmitted || min_complete) {
+        i32 result = io_uring_enter(ring->fd, ring->unsubmitted, min_complete, flags);
+        if (result < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+            PE_ERROR("io_uring_enter failed (errno %i).", errno);
+            return;
+        }
+        ring->unsubmitted -= (u32)result < ring->unsubmitted ? (u32)result : ring->unsubmitted;
+        min_complete = 0;
+        flags = 0;
+    }
+}
+
+// Moves finished entries out of the completion ring.
+static void ring_reap(io_uring_ring* ring) {
+    u32 head = *ring->cq_head;
+    u32 tail = PE_ATOMIC_LOAD(ring->cq_tail, PE_ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+        struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        file_io_request* request = (file_io_request*)cqe->user_data;
+        i32 result = cqe->res;
+        head++;
+
+        ring->in_flight--;
+        request->bytes_transferred = result < 0 ? 0 : (u64)result;
+        if (request->callback) {
+            list_push(&state_ptr->completed, request);
+        }
+        PE_ATOMIC_STORE(&request->status, result < 0 ? FILE_IO_STATUS_FAILED : FILE_IO_STATUS_COMPLETE, PE_ATOMIC_RELEASE);
+    }
+
+    // Give the entries back to the kernel
+    PE_ATOMIC_STORE(ring->cq_head, head, PE_ATOMIC_RELEASE);
+}
+
+static b8 ring_queue(io_uring_ring* ring, file_io_request* request) {
+    if (request->size > U32MAX) {
+        PE_ERROR("Async I/O requests are limited to 4GiB each.");
+        return false;
+    }
+
+    // Never have more requests out than the completion ring can hold
+    while (ring->in_flight >= ring->cq_entries) {
+        ring_submit(ring, 1);
+        ring_reap(ring);
+    }
+
+    u32 tail = *ring->sq_tail;
+    if (tail - PE_ATOMIC_LOAD(ring->sq_head, PE_ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        // Submission ring is full; the kernel consumes everything on enter
+        ring_submit(ring, 0);
+    }
+
+    u32 index = tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    platform_zero_memory(sqe, sizeof(struct io_uring_sqe));
+    sqe->opcode = request->operation == FILE_IO_OPERATION_READ ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = fileno((FILE*)request->handle->handle);
+    sqe->off = request->offset;
+    sqe->addr = (u64)request->buffer;
+    sqe->len = (u32)request->size;
+    sqe->user_data = (u64)request;
+    ring->sq_array[index] = index;
+
+    // Publish the entry before the new tail
+    PE_ATOMIC_STORE(ring->sq_tail, tail + 1, PE_ATOMIC_RELEASE);
+    ring->unsubmitted++;
+    ring->in_flight++;
+    return true;
+}
+
+#endif // PE_PLATFORM_LINUX
+
+b8 filesystem_async_system_initialize(u64* memory_requirement, void* state, u32 queue_depth, u32 worker_count) {
+    if (worker_count == 0) {
+        worker_count = 1;
+    }
+    *memory_requirement = sizeof(filesystem_async_state) + sizeof(platform_thread) * worker_count;
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    platform_zero_memory(state_ptr, *memory_requirement);
+    state_ptr->workers = (platform_thread*)((u8*)state + sizeof(filesystem_async_state));
+
+#if PE_PLATFORM_LINUX
+    // A queue depth of 0 asks for the worker threads even where io_uring works
+    state_ptr->use_io_uring = queue_depth && ring_create(queue_depth, &state_ptr->ring);
+    if (state_ptr->use_io_uring) {
+        return true;
+    }
+#endif
+
+    if (!platform_mutex_create(&state_ptr->queue_mutex) ||
+        !platform_condvar_create(&state_ptr->queue_condvar) ||
+        !platform_mutex_create(&state_ptr->completed_mutex) ||
+        !platform_condvar_create(&state_ptr->completed_condvar)) {
+        PE_ERROR("Failed to create async I/O synchronization objects.");
+        return false;
+    }
+
+    state_ptr->running = true;
+    for (u32 i = 0; i < worker_count; ++i) {
+        if (!platform_thread_create(file_io_worker_run, 0, false, &state_ptr->workers[i])) {
+            PE_ERROR("Failed to start async I/O worker thread.");
+            return false;
+        }
+        state_ptr->worker_count++;
+    }
+
+    PE_INFO("Async I/O using %u worker threads.", state_ptr->worker_count);
+    return true;
+}
+
+void filesystem_async_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+#if PE_PLATFORM_LINUX
+    if (state_ptr->use_io_uring) {
+        // Outstanding requests still reference caller memory; let them finish
+        while (state_ptr->ring.in_flight) {
+            ring_submit(&state_ptr->ring, 1);
+            ring_reap(&state_ptr->ring);
+        }
+        ring_destroy(&state_ptr->ring);
+        state_ptr = 0;
+        return;
+    }
+#endif
+
+    // Workers drain the remaining requests before exiting
+    filesystem_async_submit();
+    platform_mutex_lock(&state_ptr->queue_mutex);
+    state_ptr->running = false;
+    platform_condvar_broadcast(&state_ptr->queue_condvar);
+    platform_mutex_unlock(&state_ptr->queue_mutex);
+
+    for (u32 i = 0; i < state_ptr->worker_count; ++i) {
+        platform_thread_join(&state_ptr->workers[i]);
+    }
+
+    platform_condvar_destroy(&state_ptr->completed_condvar);
+    platform_mutex_destroy(&state_ptr->completed_mutex);
+    platform_condvar_destroy(&state_ptr->queue_condvar);
+    platform_mutex_destroy(&state_ptr->queue_mutex);
+    state_ptr = 0;
+}
+
+static b8 file_io_queue(file_io_request* request, file_io_operation operation) {
+    if (!state_ptr) {
+        PE_ERROR("Async I/O requested before the async I/O system was initialized.");
+        return false;
+    }
+    if (!request || !request->handle || !request->handle->handle || (!request->buffer && request->size)) {
+        PE_ERROR("Invalid async I/O request.");
+        return false;
+    }
+
+    request->operation = operation;
+    request->bytes_transferred = 0;
+    request->next = 0;
+    PE_ATOMIC_STORE(&request->status, FILE_IO_STATUS_PENDING, PE_ATOMIC_RELAXED);
+
+#if PE_PLATFORM_LINUX
+    if (state_ptr->use_io_uring) {
+        return ring_queue(&state_ptr->ring, request);
+    }
+#endif
+
+    // Only the main thread touches the queued list, so no lock until submit
+    list_push(&state_ptr->queued, request);
+    return true;
+}
+
+b8 filesystem_read_async(file_io_request* request) {
+    return file_io_queue(request, FILE_IO_OPERATION_READ);
+}
+
+b8 filesystem_write_async(file_io_request* request) {
+    return file_io_queue(request, FILE_IO_OPERATION_WRITE);
+}
+
+void filesystem_async_submit() {
+    if (!state_ptr) {
+        return;
+    }
+
+#if PE_PLATFORM_LINUX
+    if (state_ptr->use_io_uring) {
+        ring_submit(&state_ptr->ring, 0);
+        return;
+    }
+#endif
+
+    if (state_ptr->queued.head) {
+        platform_mutex_lock(&state_ptr->queue_mutex);
+        list_append(&state_ptr->pending, &state_ptr->queued);
+        platform_condvar_broadcast(&state_ptr->queue_condvar);
+        platform_mutex_unlock(&state_ptr->queue_mutex);
+    }
+}
+
+b8 filesystem_async_poll(file_io_request* request) {
+#if PE_PLATFORM_LINUX
+    if (state_ptr && state_ptr->use_io_uring && PE_ATOMIC_LOAD(&request->status, PE_ATOMIC_ACQUIRE) == FILE_IO_STATUS_PENDING) {
+        ring_reap(&state_ptr->ring);
+    }
+#endif
+    return PE_ATOMIC_LOAD(&request->status, PE_ATOMIC_ACQUIRE) != FILE_IO_STATUS_PENDING;
+}
+
+b8 filesystem_async_wait(file_io_request* request) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    filesystem_async_submit();
+
+#if PE_PLATFORM_LINUX
+    if (state_ptr->use_io_uring) {
+        while (PE_ATOMIC_LOAD(&request->status, PE_ATOMIC_ACQUIRE) == FILE_IO_STATUS_PENDING) {
+            ring_reap(&state_ptr->ring);
+            if (PE_ATOMIC_LOAD(&request->status, PE_ATOMIC_ACQUIRE) != FILE_IO_STATUS_PENDING) {
+                break;
+            }
+            ring_submit(&state_ptr->ring, 1);
+        }
+        return request->status == FILE_IO_STATUS_COMPLETE;
+    }
+#endif
+
+    platform_mutex_lock(&state_ptr->completed_mutex);
+    while (PE_ATOMIC_LOAD(&request->status, PE_ATOMIC_ACQUIRE) == FILE_IO_STATUS_PENDING) {
+        platform_condvar_wait(&state_ptr->completed_condvar, &state_ptr->completed_mutex);
+    }
+    platform_mutex_unlock(&state_ptr->completed_mutex);
+
+    return request->status == FILE_IO_STATUS_COMPLETE;
+}
+
+void filesystem_async_update() {
+    if (!state_ptr) {
+        return;
+    }
+
+    filesystem_async_submit();
+
+    file_io_list finished = {0};
+#if PE_PLATFORM_LINUX
+    if (state_ptr->use_io_uring) {
+        ring_reap(&state_ptr->ring);
+        finished = state_ptr->completed;
+        state_ptr->completed.head = 0;
+        state_ptr->completed.tail = 0;
+    } else
+#endif
+    {
+        platform_mutex_lock(&state_ptr->completed_mutex);
+        finished = state_ptr->completed;
+        state_ptr->completed.head = 0;
+        state_ptr->completed.tail = 0;
+        platform_mutex_unlock(&state_ptr->completed_mutex);
+    }
+
+    // Callbacks may queue new requests or free this one, so unlink before calling
+    file_io_request* request = list_pop(&finished);
+    while (request) {
+        request->callback(request);
+        request = list_pop(&finished);
+    }
+}
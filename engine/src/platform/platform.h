@@ -17,12 +17,38 @@ void platform_system_shutdown(void* plat_state);
 
 b8 platform_pump_messages();
 
+typedef enum platform_memory_flags {
+    PLATFORM_MEMORY_FLAG_NONE = 0x0,
+    // Advise the OS to back the range with transparent huge pages where available.
+    PLATFORM_MEMORY_FLAG_HUGE_PAGES = 0x1,
+    // Back the range with explicit (pre-reserved) huge pages. The whole range is
+    // committed on reserve, and reservation fails if the OS has none available.
+    PLATFORM_MEMORY_FLAG_EXPLICIT_HUGE_PAGES = 0x2
+} platform_memory_flags;
+
 void* platform_allocate(u64 size, b8 aligned);
 void platform_free(void* block, b8 aligned);
+// Resizes a block from platform_allocate (not aligned), moving it if needed. Returns 0 on failure, leaving block intact.
+void* platform_reallocate(void* block, u64 size);
 void* platform_zero_memory(void* block, u64 size);
 void* platform_copy_memory(void* dst, const void* src, u64 size);
+// Like platform_copy_memory, but the ranges may overlap
+void* platform_move_memory(void* dst, const void* src, u64 size);
 void* platform_set_memory(void* dst, i32 value, u64 size);
 
+// Virtual memory. Sizes and addresses passed to these should be multiples of the page size.
+u64 platform_get_page_size();
+u64 platform_get_huge_page_size();
+
+// Reserves address space without backing it with memory. Returns 0 on failure.
+void* platform_memory_reserve(u64 size, u32 flags);
+// Backs a reserved range with readable/writable, zeroed memory.
+b8 platform_memory_commit(void* address, u64 size, u32 flags);
+// Returns the memory backing the range to the OS, but keeps the address space reserved.
+void platform_memory_decommit(void* address, u64 size);
+// Releases a whole range obtained from platform_memory_reserve.
+void platform_memory_release(void* address, u64 size);
+
 void platform_console_write(const char* message, u8 colour);
 void platform_console_write_error(const char* message, u8 colour);
 
@@ -31,4 +57,87 @@ f64 platform_get_absolute_time();
 // Sleep on thread for the provided ms. This blocks the main thread.
 // Should only be used for giving time back to the OS for unused update power.
 // Therefore it is not exported.
-void platform_sleep(u64 ms);
\ No newline at end of file
+void platform_sleep(u64 ms);
+
+// Sleep with microsecond resolution. The OS may still overshoot the request,
+// by up to a scheduler tick on some systems; see core/frame_pacer.h.
+void platform_sleep_microseconds(u64 microseconds);
+
+// Threading
+
+// Entry point of a thread. The return value is the thread's exit code.
+typedef u32 (*pfn_thread_start)(void* params);
+
+typedef struct platform_thread {
+    void* internal_data;
+    u64 thread_id;
+} platform_thread;
+
+/**
+ * @brief Starts a new thread running start_function.
+ * 
+ * @param start_function The function the thread runs.
+ * @param params Passed to start_function. Must outlive the thread's use of it.
+ * @param auto_detach Detach right away; the thread cleans up after itself and cannot be joined.
+ * @param out_thread Holds the created thread. Left zeroed when auto_detach is set.
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 platform_thread_create(pfn_thread_start start_function, void* params, b8 auto_detach, platform_thread* out_thread);
+// Blocks until the thread exits and releases it.
+PE_API b8 platform_thread_join(platform_thread* thread);
+// Lets the thread run on and clean up after itself.
+PE_API void platform_thread_detach(platform_thread* thread);
+PE_API void platform_thread_yield();
+PE_API u64 platform_current_thread_id();
+
+typedef struct platform_mutex {
+    void* internal_data;
+} platform_mutex;
+
+PE_API b8 platform_mutex_create(platform_mutex* out_mutex);
+PE_API void platform_mutex_destroy(platform_mutex* mutex);
+PE_API b8 platform_mutex_lock(platform_mutex* mutex);
+PE_API b8 platform_mutex_unlock(platform_mutex* mutex);
+
+// Lightweight counting semaphore. Acquiring an available count never enters the kernel;
+// waiting blocks on a futex (Linux) or WaitOnAddress (Windows).
+// Zero initialized memory is a valid semaphore with a count of 0.
+typedef struct platform_semaphore {
+    volatile i32 count;
+    volatile i32 waiters;
+} platform_semaphore;
+
+PE_API void platform_semaphore_create(platform_semaphore* out_semaphore, u32 initial_count);
+PE_API void platform_semaphore_destroy(platform_semaphore* semaphore);
+// Blocks until a count is available, then takes it.
+PE_API void platform_semaphore_wait(platform_semaphore* semaphore);
+// Takes a count if one is available without blocking. Returns false otherwise.
+PE_API b8 platform_semaphore_try_wait(platform_semaphore* semaphore);
+PE_API void platform_semaphore_signal(platform_semaphore* semaphore, u32 count);
+
+typedef struct platform_condvar {
+    void* internal_data;
+} platform_condvar;
+
+PE_API b8 platform_condvar_create(platform_condvar* out_condvar);
+PE_API void platform_condvar_destroy(platform_condvar* condvar);
+// Atomically unlocks the mutex and waits. The mutex is locked again on return.
+// Spurious wakeups are possible, so always wait in a loop checking the condition.
+PE_API void platform_condvar_wait(platform_condvar* condvar, platform_mutex* mutex);
+PE_API void platform_condvar_signal(platform_condvar* condvar);
+PE_API void platform_condvar_broadcast(platform_condvar* condvar);
+
+typedef struct platform_processor_info {
+    // Hardware threads available to the process
+    u32 logical_core_count;
+    // Physical cores; equal to logical_core_count without SMT
+    u32 physical_core_count;
+    u32 cache_line_size;
+    // Sizes in bytes, 0 if unknown. L1 and L2 are per core, L3 is usually shared.
+    u64 l1_data_cache_size;
+    u64 l2_cache_size;
+    u64 l3_cache_size;
+} platform_processor_info;
+
+// Queries the CPU topology, so worker pools can size themselves.
+PE_API void platform_get_processor_info(platform_processor_info* out_info);
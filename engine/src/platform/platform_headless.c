@@ -0,0 +1,74 @@
+#include "platform.h"
+
+// Headless platform layer. Replaces the windowing half of the OS platform layer
+// (memory, console and timing still come from platform_linux.c / platform_win32.c).
+// There is no window and no surface: the Vulkan backend renders into offscreen
+// targets instead of a swapchain.
+#if PE_HEADLESS
+
+#include "core/logger.h"
+#include "core/event.h"
+
+#include "renderer/vulkan/vulkan_types.inl"
+
+typedef struct platform_state {
+    u32 width;
+    u32 height;
+} platform_state;
+
+static platform_state* state_ptr;
+
+b8 platform_system_initialize(
+    u64* memory_requirements,
+    void* state,
+    const char* application_name,
+    i32 x,
+    i32 y,
+    i32 width,
+    i32 height){
+
+    *memory_requirements = sizeof(platform_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    state_ptr->width = width;
+    state_ptr->height = height;
+
+    PE_INFO("Headless platform initialized for '%s' (%ix%i offscreen).", application_name, width, height);
+
+    // There is no window to report its size, so announce the requested
+    // render target size the same way a window manager would.
+    event_context context;
+    context.data.u16[0] = (u16)width;
+    context.data.u16[1] = (u16)height;
+    event_fire(EVENT_CODE_RESIZED, 0, context);
+
+    return true;
+}
+
+void platform_system_shutdown(void* plat_state) {
+    state_ptr = 0;
+}
+
+b8 platform_pump_messages() {
+    // No OS messages without a window
+    return true;
+}
+
+void platform_get_required_extension_names(const char*** names_darray) {
+    // No surface, so no platform surface extension
+}
+
+b8 platform_create_vulkan_surface(vulkan_context* context) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    // A null surface tells the backend to render into offscreen images
+    context->surface = 0;
+    return true;
+}
+
+#endif // PE_HEADLESS
@@ -0,0 +1,1035 @@
+#include "platform.h"
+
+// Linux platform layer
+#if PE_PLATFORM_LINUX
+
+#include "core/logger.h"
+#include "core/input.h"
+#include "core/event.h"
+
+#include "containers/darray.h"
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The windowing half of the platform layer is replaced by platform_headless.c
+// in headless builds.
+#if !PE_HEADLESS
+
+#include <xcb/xcb.h>
+#include <X11/keysym.h>
+#include <X11/XKBlib.h> // sudo apt-get install libx11-dev
+#include <X11/Xlib.h>
+#include <X11/Xlib-xcb.h> // sudo apt-get install libxkbcommon-x11-dev
+
+// For surface creation; see renderer/vulkan/vulkan_platform.h
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_xcb.h>
+#include "renderer/vulkan/vulkan_types.inl"
+
+typedef struct platform_state {
+    Display* display;
+    xcb_connection_t* connection;
+    xcb_window_t window;
+    xcb_screen_t* screen;
+    xcb_atom_t wm_protocols;
+    xcb_atom_t wm_delete_win;
+} platform_state;
+
+static platform_state* state_ptr;
+
+// Key translation
+keys translate_keycode(u32 x_keycode);
+
+b8 platform_system_initialize(
+    u64* memory_requirements,
+    void* state,
+    const char* application_name,
+    i32 x,
+    i32 y,
+    i32 width,
+    i32 height){
+
+    *memory_requirements = sizeof(platform_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+
+    // Connect to X
+    state_ptr->display = XOpenDisplay(NULL);
+    if (!state_ptr->display) {
+        PE_FATAL("Failed to open X display!");
+        return false;
+    }
+
+    // Report key releases only for physical releases instead of turning auto-repeat
+    // off for the whole X server.
+    XkbSetDetectableAutoRepeat(state_ptr->display, True, NULL);
+
+    // Retrieve the connection from the display
+    state_ptr->connection = XGetXCBConnection(state_ptr->display);
+    if (xcb_connection_has_error(state_ptr->connection)) {
+        PE_FATAL("Failed to connect to X server via XCB!");
+        return false;
+    }
+
+    // Get data from the X server and loop through screens using iterator
+    const struct xcb_setup_t* setup = xcb_get_setup(state_ptr->connection);
+    xcb_screen_iterator_t it = xcb_setup_roots_iterator(setup);
+    int screen_p = 0;
+    for (i32 s = screen_p; s > 0; s--) {
+        xcb_screen_next(&it);
+    }
+
+    // After screens have been looped through, assign it
+    state_ptr->screen = it.data;
+
+    // Allocate a XID for the window to be created
+    state_ptr->window = xcb_generate_id(state_ptr->connection);
+
+    // Register event types.
+    // XCB_CW_BACK_PIXEL = filling then window bg with a single colour
+    // XCB_CW_EVENT_MASK is required.
+    u32 event_mask = XCB_CW_BACK_PIXEL | XCB_CW_EVENT_MASK;
+
+    // Listen for keyboard and mouse buttons
+    u32 event_values = XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
+                       XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE |
+                       XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_POINTER_MOTION |
+                       XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+
+    // Values to be sent over XCB (bg colour, events)
+    u32 value_list[] = {state_ptr->screen->black_pixel, event_values};
+
+    // Create the window
+    xcb_create_window(
+        state_ptr->connection,
+        XCB_COPY_FROM_PARENT,  // depth
+        state_ptr->window,
+        state_ptr->screen->root,  // parent
+        x,
+        y,
+        width,
+        height,
+        0,  // No border
+        XCB_WINDOW_CLASS_INPUT_OUTPUT,
+        state_ptr->screen->root_visual,
+        event_mask,
+        value_list);
+
+    // Change the title
+    xcb_change_property(
+        state_ptr->connection,
+        XCB_PROP_MODE_REPLACE,
+        state_ptr->window,
+        XCB_ATOM_WM_NAME,
+        XCB_ATOM_STRING,
+        8,  // data should be viewed 8 bits at a time
+        strlen(application_name),
+        application_name);
+
+    // Tell the server to notify when the window manager attempts to destroy the window.
+    xcb_intern_atom_cookie_t wm_delete_cookie = xcb_intern_atom(
+        state_ptr->connection,
+        0,
+        strlen("WM_DELETE_WINDOW"),
+        "WM_DELETE_WINDOW");
+    xcb_intern_atom_cookie_t wm_protocols_cookie = xcb_intern_atom(
+        state_ptr->connection,
+        0,
+        strlen("WM_PROTOCOLS"),
+        "WM_PROTOCOLS");
+    xcb_intern_atom_reply_t* wm_delete_reply = xcb_intern_atom_reply(
+        state_ptr->connection,
+        wm_delete_cookie,
+        NULL);
+    xcb_intern_atom_reply_t* wm_protocols_reply = xcb_intern_atom_reply(
+        state_ptr->connection,
+        wm_protocols_cookie,
+        NULL);
+    if (!wm_delete_reply || !wm_protocols_reply) {
+        PE_FATAL("Failed to intern the window manager protocol atoms!");
+        // free ignores the reply that didn't arrive
+        free(wm_delete_reply);
+        free(wm_protocols_reply);
+        // Destroys the window and closes the display, which owns the XCB connection
+        platform_system_shutdown(state_ptr);
+        return false;
+    }
+    state_ptr->wm_delete_win = wm_delete_reply->atom;
+    state_ptr->wm_protocols = wm_protocols_reply->atom;
+    free(wm_delete_reply);
+    free(wm_protocols_reply);
+
+    xcb_change_property(
+        state_ptr->connection,
+        XCB_PROP_MODE_REPLACE,
+        state_ptr->window,
+        state_ptr->wm_protocols,
+        4,
+        32,
+        1,
+        &state_ptr->wm_delete_win);
+
+    // Map the window to the screen
+    xcb_map_window(state_ptr->connection, state_ptr->window);
+
+    // Flush the stream
+    i32 stream_result = xcb_flush(state_ptr->connection);
+    if (stream_result <= 0) {
+        PE_FATAL("An error occurred when flusing the stream: %d", stream_result);
+        return false;
+    }
+
+    return true;
+}
+
+void platform_system_shutdown(void* plat_state) {
+    if (state_ptr) {
+        if (state_ptr->connection && state_ptr->window) {
+            xcb_destroy_window(state_ptr->connection, state_ptr->window);
+            state_ptr->window = 0;
+        }
+        if (state_ptr->display) {
+            XCloseDisplay(state_ptr->display);
+            state_ptr->display = 0;
+            state_ptr->connection = 0;
+        }
+    }
+    state_ptr = 0;
+}
+
+b8 platform_pump_messages() {
+    if (!state_ptr) {
+        return true;
+    }
+
+    xcb_generic_event_t* event;
+    xcb_client_message_event_t* cm;
+
+    b8 quit_flagged = false;
+
+    // Drain everything already queued on the connection in one pass. xcb_poll_for_event
+    // never blocks, so input latency is bound by the frame, not by the X server.
+    while ((event = xcb_poll_for_event(state_ptr->connection))) {
+        // Input events
+        switch (event->response_type & ~0x80) {
+            case XCB_KEY_PRESS:
+            case XCB_KEY_RELEASE: {
+                // Key press event - xcb_key_press_event_t and xcb_key_release_event_t are the same
+                xcb_key_press_event_t* kb_event = (xcb_key_press_event_t*)event;
+                b8 pressed = event->response_type == XCB_KEY_PRESS;
+                xcb_keycode_t code = kb_event->detail;
+                KeySym key_sym = XkbKeycodeToKeysym(
+                    state_ptr->display,
+                    (KeyCode)code,  // event.xkey.keycode,
+                    0,
+                    0 /*code & ShiftMask ? 1 : 0*/);
+
+                keys key = translate_keycode(key_sym);
+
+                // Pass to the input subsystem for processing
+                input_process_key(key, pressed);
+            } break;
+            case XCB_BUTTON_PRESS:
+            case XCB_BUTTON_RELEASE: {
+                xcb_button_press_event_t* mouse_event = (xcb_button_press_event_t*)event;
+                b8 pressed = event->response_type == XCB_BUTTON_PRESS;
+                buttons mouse_button = BUTTON_MAX_BUTTONS;
+                switch (mouse_event->detail) {
+                    case XCB_BUTTON_INDEX_1:
+                        mouse_button = BUTTON_LEFT;
+                        break;
+                    case XCB_BUTTON_INDEX_2:
+                        mouse_button = BUTTON_MIDLE;
+                        break;
+                    case XCB_BUTTON_INDEX_3:
+                        mouse_button = BUTTON_RIGHT;
+                        break;
+                    case XCB_BUTTON_INDEX_4:
+                    case XCB_BUTTON_INDEX_5:
+                        // X reports the wheel as buttons 4 (up) and 5 (down).
+                        // Only the press is meaningful; flatten to OS independent (-1, 1)
+                        if (pressed) {
+                            input_process_mouse_wheel(mouse_event->detail == XCB_BUTTON_INDEX_4 ? 1 : -1);
+                        }
+                        break;
+                }
+
+                // Pass over to the input subsystem.
+                if (mouse_button != BUTTON_MAX_BUTTONS) {
+                    input_process_button(mouse_button, pressed);
+                }
+            } break;
+            case XCB_MOTION_NOTIFY: {
+                // Mouse move
+                xcb_motion_notify_event_t* move_event = (xcb_motion_notify_event_t*)event;
+
+                // Pass over to the input subsystem.
+                input_process_mouse_move(move_event->event_x, move_event->event_y);
+            } break;
+            case XCB_CONFIGURE_NOTIFY: {
+                // Resizing - note that this is also triggered by moving the window, but should be
+                // passed anyway since a change in the x/y could mean an upper-left resize.
+                // The application layer can decide what to do with this.
+                xcb_configure_notify_event_t* configure_event = (xcb_configure_notify_event_t*)event;
+
+                // Fire the event. The application layer should pick this up, but not handle it
+                // as it shouldn't be visible to other parts of the application
+                event_context context;
+                context.data.u16[0] = configure_event->width;
+                context.data.u16[1] = configure_event->height;
+                event_fire(EVENT_CODE_RESIZED, 0, context);
+            } break;
+            case XCB_CLIENT_MESSAGE: {
+                cm = (xcb_client_message_event_t*)event;
+
+                // Window close
+                if (cm->data.data32[0] == state_ptr->wm_delete_win) {
+                    quit_flagged = true;
+                }
+            } break;
+            default:
+                // Something else
+                break;
+        }
+
+        free(event);
+    }
+
+    return !quit_flagged;
+}
+
+#endif // !PE_HEADLESS
+
+void* platform_allocate(u64 size, b8 aligned) {
+    return malloc(size);
+}
+
+void platform_free(void* block, b8 aligned) {
+    free(block);
+}
+
+void* platform_reallocate(void* block, u64 size) {
+    return realloc(block, size);
+}
+
+void* platform_zero_memory(void* block, u64 size) {
+    return memset(block, 0, size);
+}
+
+void* platform_copy_memory(void* dst, const void* src, u64 size) {
+    return memcpy(dst, src, size);
+}
+
+void* platform_move_memory(void* dst, const void* src, u64 size) {
+    return memmove(dst, src, size);
+}
+
+void* platform_set_memory(void* dst, i32 value, u64 size) {
+    return memset(dst, value, size);
+}
+
+u64 platform_get_page_size() {
+    return (u64)sysconf(_SC_PAGESIZE);
+}
+
+u64 platform_get_huge_page_size() {
+    // Default huge page size on x86_64 and most aarch64 kernels
+    return 2 * 1024 * 1024;
+}
+
+void* platform_memory_reserve(u64 size, u32 flags) {
+    if (flags & PLATFORM_MEMORY_FLAG_EXPLICIT_HUGE_PAGES) {
+        // hugetlbfs pages cannot be committed lazily, so map them readable/writable right away
+        void* block = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        return block == MAP_FAILED ? 0 : block;
+    }
+
+    if (flags & PLATFORM_MEMORY_FLAG_HUGE_PAGES) {
+        // Transparent huge pages are only used for 2MiB-aligned ranges. Over-reserve,
+        // then trim so the range starts on a huge page boundary.
+        u64 huge_page_size = platform_get_huge_page_size();
+        u8* block = mmap(0, size + huge_page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (block == MAP_FAILED) {
+            return 0;
+        }
+        u8* aligned = (u8*)(((u64)block + huge_page_size - 1) & ~(huge_page_size - 1));
+        if (aligned != block) {
+            munmap(block, aligned - block);
+        }
+        u64 tail = (block + size + huge_page_size) - (aligned + size);
+        if (tail) {
+            munmap(aligned + size, tail);
+        }
+        return aligned;
+    }
+
+    void* block = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return block == MAP_FAILED ? 0 : block;
+}
+
+b8 platform_memory_commit(void* address, u64 size, u32 flags) {
+    if (flags & PLATFORM_MEMORY_FLAG_EXPLICIT_HUGE_PAGES) {
+        // Already committed on reserve
+        return true;
+    }
+
+    if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+    if (flags & PLATFORM_MEMORY_FLAG_HUGE_PAGES) {
+        // Advisory only; the kernel may still use small pages
+        madvise(address, size, MADV_HUGEPAGE);
+    }
+    return true;
+}
+
+void platform_memory_decommit(void* address, u64 size) {
+    // Drop the backing pages, then make the range inaccessible again
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+void platform_memory_release(void* address, u64 size) {
+    munmap(address, size);
+}
+
+void platform_console_write(const char* message, u8 colour) {
+    // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
+    const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    printf("\033[%sm%s\033[0m", colour_strings[colour], message);
+}
+
+void platform_console_write_error(const char* message, u8 colour) {
+    // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
+    const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    fprintf(stderr, "\033[%sm%s\033[0m", colour_strings[colour], message);
+}
+
+f64 platform_get_absolute_time() {
+    // CLOCK_MONOTONIC_RAW is not slewed by NTP, so frame deltas stay consistent.
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return now.tv_sec + now.tv_nsec * 0.000000001;
+}
+
+void platform_sleep(u64 ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000 * 1000;
+
+    // clock_nanosleep reports the interruption through its return value and does not
+    // update the request when a relative sleep is interrupted, so sleep to an absolute
+    // deadline instead.
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += ts.tv_sec;
+    deadline.tv_nsec += ts.tv_nsec;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0) == EINTR) {
+    }
+}
+
+void platform_sleep_microseconds(u64 microseconds) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += microseconds / 1000000;
+    deadline.tv_nsec += (microseconds % 1000000) * 1000;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0) == EINTR) {
+    }
+}
+
+// Threading
+
+typedef struct thread_start_data {
+    pfn_thread_start start_function;
+    void* params;
+} thread_start_data;
+
+static void* thread_start_trampoline(void* data) {
+    thread_start_data start_data = *(thread_start_data*)data;
+    platform_free(data, false);
+    return (void*)(u64)start_data.start_function(start_data.params);
+}
+
+b8 platform_thread_create(pfn_thread_start start_function, void* params, b8 auto_detach, platform_thread* out_thread) {
+    if (!start_function || !out_thread) {
+        return false;
+    }
+
+    thread_start_data* start_data = platform_allocate(sizeof(thread_start_data), false);
+    start_data->start_function = start_function;
+    start_data->params = params;
+
+    pthread_t thread;
+    i32 result = pthread_create(&thread, 0, thread_start_trampoline, start_data);
+    if (result != 0) {
+        PE_ERROR("platform_thread_create - pthread_create failed: %s", strerror(result));
+        platform_free(start_data, false);
+        return false;
+    }
+
+    if (auto_detach) {
+        pthread_detach(thread);
+        out_thread->internal_data = 0;
+        out_thread->thread_id = 0;
+    } else {
+        out_thread->internal_data = (void*)thread;
+        out_thread->thread_id = (u64)thread;
+    }
+    return true;
+}
+
+b8 platform_thread_join(platform_thread* thread) {
+    if (!thread || !thread->internal_data) {
+        return false;
+    }
+
+    i32 result = pthread_join((pthread_t)thread->internal_data, 0);
+    thread->internal_data = 0;
+    thread->thread_id = 0;
+    return result == 0;
+}
+
+void platform_thread_detach(platform_thread* thread) {
+    if (thread && thread->internal_data) {
+        pthread_detach((pthread_t)thread->internal_data);
+        thread->internal_data = 0;
+        thread->thread_id = 0;
+    }
+}
+
+void platform_thread_yield() {
+    sched_yield();
+}
+
+u64 platform_current_thread_id() {
+    return (u64)pthread_self();
+}
+
+b8 platform_mutex_create(platform_mutex* out_mutex) {
+    if (!out_mutex) {
+        return false;
+    }
+
+    pthread_mutex_t* mutex = platform_allocate(sizeof(pthread_mutex_t), false);
+    if (pthread_mutex_init(mutex, 0) != 0) {
+        PE_ERROR("platform_mutex_create - pthread_mutex_init failed.");
+        platform_free(mutex, false);
+        return false;
+    }
+    out_mutex->internal_data = mutex;
+    return true;
+}
+
+void platform_mutex_destroy(platform_mutex* mutex) {
+    if (mutex && mutex->internal_data) {
+        pthread_mutex_destroy(mutex->internal_data);
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+b8 platform_mutex_lock(platform_mutex* mutex) {
+    return mutex && pthread_mutex_lock(mutex->internal_data) == 0;
+}
+
+b8 platform_mutex_unlock(platform_mutex* mutex) {
+    return mutex && pthread_mutex_unlock(mutex->internal_data) == 0;
+}
+
+static void futex_wait(volatile i32* address, i32 expected) {
+    // Returns right away if *address no longer holds expected, which closes the
+    // race with a signal landing between the caller's check and this call.
+    syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, 0, 0, 0);
+}
+
+static void futex_wake(volatile i32* address, i32 count) {
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, 0, 0, 0);
+}
+
+void platform_semaphore_create(platform_semaphore* out_semaphore, u32 initial_count) {
+    out_semaphore->count = (i32)initial_count;
+    out_semaphore->waiters = 0;
+}
+
+void platform_semaphore_destroy(platform_semaphore* semaphore) {
+    semaphore->count = 0;
+    semaphore->waiters = 0;
+}
+
+b8 platform_semaphore_try_wait(platform_semaphore* semaphore) {
+    i32 count = PE_ATOMIC_LOAD(&semaphore->count, PE_ATOMIC_RELAXED);
+    while (count > 0) {
+        if (PE_ATOMIC_COMPARE_EXCHANGE_WEAK(&semaphore->count, &count, count - 1, PE_ATOMIC_ACQUIRE, PE_ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void platform_semaphore_wait(platform_semaphore* semaphore) {
+    // Spin briefly first; short waits are common and cheaper than a syscall round trip.
+    for (u32 spin = 0; spin < 64; ++spin) {
+        if (platform_semaphore_try_wait(semaphore)) {
+            return;
+        }
+        PE_CPU_PAUSE();
+    }
+
+    while (!platform_semaphore_try_wait(semaphore)) {
+        // Registering as a waiter before re-checking the count pairs with signal
+        // bumping the count before checking for waiters, so a wakeup can't be lost.
+        PE_ATOMIC_FETCH_ADD(&semaphore->waiters, 1, PE_ATOMIC_SEQ_CST);
+        futex_wait(&semaphore->count, 0);
+        PE_ATOMIC_FETCH_SUB(&semaphore->waiters, 1, PE_ATOMIC_RELAXED);
+    }
+}
+
+void platform_semaphore_signal(platform_semaphore* semaphore, u32 count) {
+    PE_ATOMIC_FETCH_ADD(&semaphore->count, (i32)count, PE_ATOMIC_SEQ_CST);
+    if (PE_ATOMIC_LOAD(&semaphore->waiters, PE_ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&semaphore->count, (i32)count);
+    }
+}
+
+b8 platform_condvar_create(platform_condvar* out_condvar) {
+    if (!out_condvar) {
+        return false;
+    }
+
+    pthread_cond_t* condvar = platform_allocate(sizeof(pthread_cond_t), false);
+    if (pthread_cond_init(condvar, 0) != 0) {
+        PE_ERROR("platform_condvar_create - pthread_cond_init failed.");
+        platform_free(condvar, false);
+        return false;
+    }
+    out_condvar->internal_data = condvar;
+    return true;
+}
+
+void platform_condvar_destroy(platform_condvar* condvar) {
+    if (condvar && condvar->internal_data) {
+        pthread_cond_destroy(condvar->internal_data);
+        platform_free(condvar->internal_data, false);
+        condvar->internal_data = 0;
+    }
+}
+
+void platform_condvar_wait(platform_condvar* condvar, platform_mutex* mutex) {
+    pthread_cond_wait(condvar->internal_data, mutex->internal_data);
+}
+
+void platform_condvar_signal(platform_condvar* condvar) {
+    pthread_cond_signal(condvar->internal_data);
+}
+
+void platform_condvar_broadcast(platform_condvar* condvar) {
+    pthread_cond_broadcast(condvar->internal_data);
+}
+
+static b8 read_sysfs_u64(const char* path, u64* out_value, char* out_suffix) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char suffix = 0;
+    i32 read = fscanf(file, "%llu%c", out_value, &suffix);
+    fclose(file);
+    if (out_suffix) {
+        *out_suffix = suffix;
+    }
+    return read >= 1;
+}
+
+void platform_get_processor_info(platform_processor_info* out_info) {
+    platform_zero_memory(out_info, sizeof(platform_processor_info));
+
+    i64 online = sysconf(_SC_NPROCESSORS_ONLN);
+    out_info->logical_core_count = online > 0 ? (u32)online : 1;
+
+    // A core is counted once, through the first hardware thread listed among its siblings.
+    char path[128];
+    for (u32 i = 0; i < out_info->logical_core_count; ++i) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", i);
+        u64 first_sibling = 0;
+        if (read_sysfs_u64(path, &first_sibling, 0) && first_sibling == i) {
+            out_info->physical_core_count++;
+        }
+    }
+    if (out_info->physical_core_count == 0) {
+        out_info->physical_core_count = out_info->logical_core_count;
+    }
+
+    // Caches as seen from cpu0. Sizes are reported like "48K".
+    for (u32 index = 0;; ++index) {
+        u64 level = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+        if (!read_sysfs_u64(path, &level, 0)) {
+            break;
+        }
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+        FILE* file = fopen(path, "r");
+        char type[16] = "";
+        if (file) {
+            if (!fgets(type, sizeof(type), file)) {
+                type[0] = 0;
+            }
+            fclose(file);
+        }
+        if (strncmp(type, "Instruction", 11) == 0) {
+            continue;
+        }
+
+        u64 size = 0;
+        char unit = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+        if (read_sysfs_u64(path, &size, &unit)) {
+            if (unit == 'K') {
+                size *= 1024;
+            } else if (unit == 'M') {
+                size *= 1024 * 1024;
+            }
+        }
+
+        if (level == 1) {
+            out_info->l1_data_cache_size = size;
+            u64 line_size = 0;
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", index);
+            if (read_sysfs_u64(path, &line_size, 0)) {
+                out_info->cache_line_size = (u32)line_size;
+            }
+        } else if (level == 2) {
+            out_info->l2_cache_size = size;
+        } else if (level == 3) {
+            out_info->l3_cache_size = size;
+        }
+    }
+
+    if (out_info->cache_line_size == 0) {
+        out_info->cache_line_size = 64;
+    }
+}
+
+#if !PE_HEADLESS
+
+void platform_get_required_extension_names(const char*** names_darray) {
+    darray_push(*names_darray, "VK_KHR_xcb_surface");
+}
+
+b8 platform_create_vulkan_surface(vulkan_context* context) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    VkXcbSurfaceCreateInfoKHR create_info = {VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR};
+    create_info.connection = state_ptr->connection;
+    create_info.window = state_ptr->window;
+
+    // The surface belongs to the renderer, which destroys it along with the instance
+    VkResult result = vkCreateXcbSurfaceKHR(context->instance, &create_info, context->allocator, &context->surface);
+    if (result != VK_SUCCESS) {
+        PE_FATAL("Vulkan surface creation failed!");
+        return false;
+    }
+
+    return true;
+}
+
+// Key translation
+keys translate_keycode(u32 x_keycode) {
+    switch (x_keycode) {
+        case XK_BackSpace:
+            return KEY_BACKSPACE;
+        case XK_Return:
+            return KEY_ENTER;
+        case XK_Tab:
+            return KEY_TAB;
+            // case XK_Shift: return KEY_SHIFT;
+            // case XK_Control: return KEY_CONTROL;
+
+        case XK_Pause:
+            return KEY_PAUSE;
+        case XK_Caps_Lock:
+            return KEY_CAPITAL;
+
+        case XK_Escape:
+            return KEY_ESCAPE;
+
+            // Not supported
+            // case : return KEY_CONVERT;
+            // case : return KEY_NONCONVERT;
+            // case : return KEY_ACCEPT;
+
+        case XK_Mode_switch:
+            return KEY_MODECHANGE;
+
+        case XK_space:
+            return KEY_SPACE;
+        case XK_Prior:
+            return KEY_PRIOR;
+        case XK_Next:
+            return KEY_NEXT;
+        case XK_End:
+            return KEY_END;
+        case XK_Home:
+            return KEY_HOME;
+        case XK_Left:
+            return KEY_LEFT;
+        case XK_Up:
+            return KEY_UP;
+        case XK_Right:
+            return KEY_RIGHT;
+        case XK_Down:
+            return KEY_DOWN;
+        case XK_Select:
+            return KEY_SELECT;
+        case XK_Print:
+            return KEY_PRINT;
+        case XK_Execute:
+            return KEY_EXECUTE;
+        // case XK_snapshot: return KEY_SNAPSHOT; // not supported
+        case XK_Insert:
+            return KEY_INSERT;
+        case XK_Delete:
+            return KEY_DELETE;
+        case XK_Help:
+            return KEY_HELP;
+
+        // The Windows key is Super on most X keymaps; Meta on some older ones
+        case XK_Super_L:
+        case XK_Meta_L:
+            return KEY_LWIN;
+        case XK_Super_R:
+        case XK_Meta_R:
+            return KEY_RWIN;
+            // case XK_apps: return KEY_APPS; // not supported
+
+            // case XK_sleep: return KEY_SLEEP; //not supported
+
+        case XK_KP_0:
+            return KEY_NUMPAD0;
+        case XK_KP_1:
+            return KEY_NUMPAD1;
+        case XK_KP_2:
+            return KEY_NUMPAD2;
+        case XK_KP_3:
+            return KEY_NUMPAD3;
+        case XK_KP_4:
+            return KEY_NUMPAD4;
+        case XK_KP_5:
+            return KEY_NUMPAD5;
+        case XK_KP_6:
+            return KEY_NUMPAD6;
+        case XK_KP_7:
+            return KEY_NUMPAD7;
+        case XK_KP_8:
+            return KEY_NUMPAD8;
+        case XK_KP_9:
+            return KEY_NUMPAD9;
+        case XK_multiply:
+            return KEY_MULTIPLY;
+        case XK_KP_Add:
+            return KEY_ADD;
+        case XK_KP_Separator:
+            return KEY_SEPARATOR;
+        case XK_KP_Subtract:
+            return KEY_SUBTRACT;
+        case XK_KP_Decimal:
+            return KEY_DECIMAL;
+        case XK_KP_Divide:
+            return KEY_DIVIDE;
+        case XK_F1:
+            return KEY_F1;
+        case XK_F2:
+            return KEY_F2;
+        case XK_F3:
+            return KEY_F3;
+        case XK_F4:
+            return KEY_F4;
+        case XK_F5:
+            return KEY_F5;
+        case XK_F6:
+            return KEY_F6;
+        case XK_F7:
+            return KEY_F7;
+        case XK_F8:
+            return KEY_F8;
+        case XK_F9:
+            return KEY_F9;
+        case XK_F10:
+            return KEY_F10;
+        case XK_F11:
+            return KEY_F11;
+        case XK_F12:
+            return KEY_F12;
+        case XK_F13:
+            return KEY_F13;
+        case XK_F14:
+            return KEY_F14;
+        case XK_F15:
+            return KEY_F15;
+        case XK_F16:
+            return KEY_F16;
+        case XK_F17:
+            return KEY_F17;
+        case XK_F18:
+            return KEY_F18;
+        case XK_F19:
+            return KEY_F19;
+        case XK_F20:
+            return KEY_F20;
+        case XK_F21:
+            return KEY_F21;
+        case XK_F22:
+            return KEY_F22;
+        case XK_F23:
+            return KEY_F23;
+        case XK_F24:
+            return KEY_F24;
+
+        case XK_Num_Lock:
+            return KEY_NUMLOCK;
+        case XK_Scroll_Lock:
+            return KEY_SCROLL;
+
+        case XK_KP_Equal:
+            return KEY_NUMPAD_EQUAL;
+
+        case XK_Shift_L:
+            return KEY_LSHIFT;
+        case XK_Shift_R:
+            return KEY_RSHIFT;
+        case XK_Control_L:
+            return KEY_LCONTROL;
+        case XK_Control_R:
+            return KEY_RCONTROL;
+        case XK_Alt_L:
+            return KEY_LALT;
+        case XK_Alt_R:
+            return KEY_RALT;
+
+        case XK_semicolon:
+            return KEY_SEMICOLON;
+        case XK_plus:
+            return KEY_PLUS;
+        case XK_comma:
+            return KEY_COMMA;
+        case XK_minus:
+            return KEY_MINUS;
+        case XK_period:
+            return KEY_PERIOD;
+        case XK_slash:
+            return KEY_SLASH;
+        case XK_grave:
+            return KEY_GRAVE;
+
+        case XK_a:
+        case XK_A:
+            return KEY_A;
+        case XK_b:
+        case XK_B:
+            return KEY_B;
+        case XK_c:
+        case XK_C:
+            return KEY_C;
+        case XK_d:
+        case XK_D:
+            return KEY_D;
+        case XK_e:
+        case XK_E:
+            return KEY_E;
+        case XK_f:
+        case XK_F:
+            return KEY_F;
+        case XK_g:
+        case XK_G:
+            return KEY_G;
+        case XK_h:
+        case XK_H:
+            return KEY_H;
+        case XK_i:
+        case XK_I:
+            return KEY_I;
+        case XK_j:
+        case XK_J:
+            return KEY_J;
+        case XK_k:
+        case XK_K:
+            return KEY_K;
+        case XK_l:
+        case XK_L:
+            return KEY_L;
+        case XK_m:
+        case XK_M:
+            return KEY_M;
+        case XK_n:
+        case XK_N:
+            return KEY_N;
+        case XK_o:
+        case XK_O:
+            return KEY_O;
+        case XK_p:
+        case XK_P:
+            return KEY_P;
+        case XK_q:
+        case XK_Q:
+            return KEY_Q;
+        case XK_r:
+        case XK_R:
+            return KEY_R;
+        case XK_s:
+        case XK_S:
+            return KEY_S;
+        case XK_t:
+        case XK_T:
+            return KEY_T;
+        case XK_u:
+        case XK_U:
+            return KEY_U;
+        case XK_v:
+        case XK_V:
+            return KEY_V;
+        case XK_w:
+        case XK_W:
+            return KEY_W;
+        case XK_x:
+        case XK_X:
+            return KEY_X;
+        case XK_y:
+        case XK_Y:
+            return KEY_Y;
+        case XK_z:
+        case XK_Z:
+            return KEY_Z;
+
+        default:
+            return 0;
+    }
+}
+
+#endif // !PE_HEADLESS
+
+#endif // PE_PLATFORM_LINUX
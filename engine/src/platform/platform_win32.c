@@ -12,6 +12,21 @@
 #include <windows.h>
 #include <windowsx.h> // param input extraction
 
+// Clock
+static f64 clock_frequency;
+static LARGE_INTEGER start_time;
+
+void clock_setup() {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    clock_frequency = 1.0 / (f64)frequency.QuadPart;
+    QueryPerformanceCounter(&start_time);
+}
+
+// The windowing half of the platform layer is replaced by platform_headless.c
+// in headless builds.
+#if !PE_HEADLESS
+
 // For surface creation
 // TODO: move vulkan specific stuff from here
 #include <vulkan/vulkan.h>
@@ -26,20 +41,10 @@ typedef struct platform_state {
     VkSurfaceKHR surface;
 } platform_state;
 
-// Clock
-static f64 clock_frequency;
-static LARGE_INTEGER start_time;
 static platform_state* state_ptr;
 
 LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARAM l_param);
 
-void clock_setup() {
-    LARGE_INTEGER frequency;
-    QueryPerformanceFrequency(&frequency);
-    clock_frequency = 1.0 / (f64)frequency.QuadPart;
-    QueryPerformanceCounter(&start_time);
-}
-
 b8 platform_system_initialize(
     u64* memory_requirements,
     void* state,
@@ -151,6 +156,8 @@ b8 platform_pump_messages(){
     return true;
 }
 
+#endif // !PE_HEADLESS
+
 void* platform_allocate(u64 size, b8 aligned) {
     return malloc(size);
 }
@@ -159,6 +166,10 @@ void platform_free(void* block, b8 aligned) {
     free(block);
 }
 
+void* platform_reallocate(void* block, u64 size) {
+    return realloc(block, size);
+}
+
 void* platform_zero_memory(void* block, u64 size) {
     return memset(block, 0, size);
 }
@@ -167,11 +178,52 @@ void* platform_copy_memory(void* dst, const void* src, u64 size) {
     return memcpy(dst, src, size);
 }
 
+void* platform_move_memory(void* dst, const void* src, u64 size) {
+    return memmove(dst, src, size);
+}
+
 void* platform_set_memory(void* dst, i32 value, u64 size) {
     return memset(dst, value, size);
 }
 
 
+u64 platform_get_page_size() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+u64 platform_get_huge_page_size() {
+    // 0 if large pages are not supported
+    return GetLargePageMinimum();
+}
+
+void* platform_memory_reserve(u64 size, u32 flags) {
+    if (flags & PLATFORM_MEMORY_FLAG_EXPLICIT_HUGE_PAGES) {
+        // Large pages must be reserved and committed at once, and need SeLockMemoryPrivilege
+        return VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+    // Windows has no transparent huge pages, so PLATFORM_MEMORY_FLAG_HUGE_PAGES is ignored
+    return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+b8 platform_memory_commit(void* address, u64 size, u32 flags) {
+    if (flags & PLATFORM_MEMORY_FLAG_EXPLICIT_HUGE_PAGES) {
+        // Already committed on reserve
+        return true;
+    }
+    return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+void platform_memory_decommit(void* address, u64 size) {
+    VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+void platform_memory_release(void* address, u64 size) {
+    VirtualFree(address, 0, MEM_RELEASE);
+}
+
 void platform_console_write(const char* message, u8 colour) {
     HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
     // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
@@ -211,8 +263,263 @@ void platform_sleep(u64 ms) {
     Sleep(ms);
 }
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+void platform_sleep_microseconds(u64 microseconds) {
+    // High resolution timers (Windows 10 1803+) aren't bound to the 15.6ms scheduler tick.
+    // Created per thread, since a waitable timer can't be shared by concurrent sleepers.
+    static _Thread_local HANDLE timer = 0;
+    static _Thread_local b8 timer_unavailable = false;
+    if (!timer && !timer_unavailable) {
+        timer = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        timer_unavailable = timer == 0;
+    }
+
+    if (timer) {
+        LARGE_INTEGER due_time;
+        // Negative means relative, in 100ns units
+        due_time.QuadPart = -(LONGLONG)(microseconds * 10);
+        if (SetWaitableTimerEx(timer, &due_time, 0, 0, 0, 0, 0)) {
+            WaitForSingleObject(timer, INFINITE);
+            return;
+        }
+    }
+
+    Sleep((DWORD)(microseconds / 1000));
+}
+
+// Threading
+
+typedef struct thread_start_data {
+    pfn_thread_start start_function;
+    void* params;
+} thread_start_data;
+
+static DWORD WINAPI thread_start_trampoline(LPVOID data) {
+    thread_start_data start_data = *(thread_start_data*)data;
+    platform_free(data, false);
+    return start_data.start_function(start_data.params);
+}
+
+b8 platform_thread_create(pfn_thread_start start_function, void* params, b8 auto_detach, platform_thread* out_thread) {
+    if (!start_function || !out_thread) {
+        return false;
+    }
+
+    thread_start_data* start_data = platform_allocate(sizeof(thread_start_data), false);
+    start_data->start_function = start_function;
+    start_data->params = params;
+
+    DWORD thread_id;
+    HANDLE handle = CreateThread(0, 0, thread_start_trampoline, start_data, 0, &thread_id);
+    if (!handle) {
+        PE_ERROR("platform_thread_create - CreateThread failed: %lu", GetLastError());
+        platform_free(start_data, false);
+        return false;
+    }
+
+    if (auto_detach) {
+        CloseHandle(handle);
+        out_thread->internal_data = 0;
+        out_thread->thread_id = 0;
+    } else {
+        out_thread->internal_data = handle;
+        out_thread->thread_id = thread_id;
+    }
+    return true;
+}
+
+b8 platform_thread_join(platform_thread* thread) {
+    if (!thread || !thread->internal_data) {
+        return false;
+    }
+
+    DWORD result = WaitForSingleObject(thread->internal_data, INFINITE);
+    CloseHandle(thread->internal_data);
+    thread->internal_data = 0;
+    thread->thread_id = 0;
+    return result == WAIT_OBJECT_0;
+}
+
+void platform_thread_detach(platform_thread* thread) {
+    if (thread && thread->internal_data) {
+        CloseHandle(thread->internal_data);
+        thread->internal_data = 0;
+        thread->thread_id = 0;
+    }
+}
+
+void platform_thread_yield() {
+    SwitchToThread();
+}
+
+u64 platform_current_thread_id() {
+    return (u64)GetCurrentThreadId();
+}
+
+b8 platform_mutex_create(platform_mutex* out_mutex) {
+    if (!out_mutex) {
+        return false;
+    }
+
+    // SRW locks stay in user mode when uncontended and pair with condition variables
+    SRWLOCK* lock = platform_allocate(sizeof(SRWLOCK), false);
+    InitializeSRWLock(lock);
+    out_mutex->internal_data = lock;
+    return true;
+}
+
+void platform_mutex_destroy(platform_mutex* mutex) {
+    if (mutex && mutex->internal_data) {
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+b8 platform_mutex_lock(platform_mutex* mutex) {
+    if (!mutex) {
+        return false;
+    }
+    AcquireSRWLockExclusive(mutex->internal_data);
+    return true;
+}
+
+b8 platform_mutex_unlock(platform_mutex* mutex) {
+    if (!mutex) {
+        return false;
+    }
+    ReleaseSRWLockExclusive(mutex->internal_data);
+    return true;
+}
+
+void platform_semaphore_create(platform_semaphore* out_semaphore, u32 initial_count) {
+    out_semaphore->count = (i32)initial_count;
+    out_semaphore->waiters = 0;
+}
+
+void platform_semaphore_destroy(platform_semaphore* semaphore) {
+    semaphore->count = 0;
+    semaphore->waiters = 0;
+}
+
+b8 platform_semaphore_try_wait(platform_semaphore* semaphore) {
+    i32 count = PE_ATOMIC_LOAD(&semaphore->count, PE_ATOMIC_RELAXED);
+    while (count > 0) {
+        if (PE_ATOMIC_COMPARE_EXCHANGE_WEAK(&semaphore->count, &count, count - 1, PE_ATOMIC_ACQUIRE, PE_ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void platform_semaphore_wait(platform_semaphore* semaphore) {
+    // Spin briefly first; short waits are common and cheaper than a kernel round trip.
+    for (u32 spin = 0; spin < 64; ++spin) {
+        if (platform_semaphore_try_wait(semaphore)) {
+            return;
+        }
+        PE_CPU_PAUSE();
+    }
+
+    i32 zero = 0;
+    while (!platform_semaphore_try_wait(semaphore)) {
+        // Registering as a waiter before re-checking the count pairs with signal
+        // bumping the count before checking for waiters, so a wakeup can't be lost.
+        PE_ATOMIC_FETCH_ADD(&semaphore->waiters, 1, PE_ATOMIC_SEQ_CST);
+        WaitOnAddress(&semaphore->count, &zero, sizeof(i32), INFINITE);
+        PE_ATOMIC_FETCH_SUB(&semaphore->waiters, 1, PE_ATOMIC_RELAXED);
+    }
+}
+
+void platform_semaphore_signal(platform_semaphore* semaphore, u32 count) {
+    PE_ATOMIC_FETCH_ADD(&semaphore->count, (i32)count, PE_ATOMIC_SEQ_CST);
+    if (PE_ATOMIC_LOAD(&semaphore->waiters, PE_ATOMIC_SEQ_CST) > 0) {
+        if (count == 1) {
+            WakeByAddressSingle((PVOID)&semaphore->count);
+        } else {
+            WakeByAddressAll((PVOID)&semaphore->count);
+        }
+    }
+}
+
+b8 platform_condvar_create(platform_condvar* out_condvar) {
+    if (!out_condvar) {
+        return false;
+    }
+
+    CONDITION_VARIABLE* condvar = platform_allocate(sizeof(CONDITION_VARIABLE), false);
+    InitializeConditionVariable(condvar);
+    out_condvar->internal_data = condvar;
+    return true;
+}
+
+void platform_condvar_destroy(platform_condvar* condvar) {
+    if (condvar && condvar->internal_data) {
+        platform_free(condvar->internal_data, false);
+        condvar->internal_data = 0;
+    }
+}
+
+void platform_condvar_wait(platform_condvar* condvar, platform_mutex* mutex) {
+    SleepConditionVariableSRW(condvar->internal_data, mutex->internal_data, INFINITE, 0);
+}
+
+void platform_condvar_signal(platform_condvar* condvar) {
+    WakeConditionVariable(condvar->internal_data);
+}
+
+void platform_condvar_broadcast(platform_condvar* condvar) {
+    WakeAllConditionVariable(condvar->internal_data);
+}
+
+void platform_get_processor_info(platform_processor_info* out_info) {
+    platform_zero_memory(out_info, sizeof(platform_processor_info));
+
+    DWORD length = 0;
+    GetLogicalProcessorInformation(0, &length);
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION* entries = platform_allocate(length, false);
+    if (entries && GetLogicalProcessorInformation(entries, &length)) {
+        u32 entry_count = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+        for (u32 i = 0; i < entry_count; ++i) {
+            SYSTEM_LOGICAL_PROCESSOR_INFORMATION* entry = &entries[i];
+            if (entry->Relationship == RelationProcessorCore) {
+                out_info->physical_core_count++;
+                // One bit per hardware thread of the core
+                out_info->logical_core_count += __builtin_popcountll(entry->ProcessorMask);
+            } else if (entry->Relationship == RelationCache) {
+                CACHE_DESCRIPTOR* cache = &entry->Cache;
+                if (cache->Level == 1 && cache->Type != CacheInstruction) {
+                    out_info->l1_data_cache_size = cache->Size;
+                    out_info->cache_line_size = cache->LineSize;
+                } else if (cache->Level == 2) {
+                    out_info->l2_cache_size = cache->Size;
+                } else if (cache->Level == 3) {
+                    out_info->l3_cache_size = cache->Size;
+                }
+            }
+        }
+    }
+    platform_free(entries, false);
+
+    if (out_info->logical_core_count == 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        out_info->logical_core_count = info.dwNumberOfProcessors;
+    }
+    if (out_info->physical_core_count == 0) {
+        out_info->physical_core_count = out_info->logical_core_count;
+    }
+    if (out_info->cache_line_size == 0) {
+        out_info->cache_line_size = 64;
+    }
+}
+
+#if !PE_HEADLESS
+
 void platform_get_required_extension_names(const char*** names_darray) {
-    darray_push(*names_darray, &"VK_KHR_win32_surface");
+    darray_push(*names_darray, "VK_KHR_win32_surface");
 }
 
 b8 platform_create_vulkan_surface(vulkan_context* context){
@@ -337,4 +644,6 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, u32 msg, WPARAM w_param, LPARA
     return DefWindowProcA(hwnd, msg, w_param, l_param);
 }
 
+#endif // !PE_HEADLESS
+
 #endif // PE_PLATFORM_WINDOWS
\ No newline at end of file
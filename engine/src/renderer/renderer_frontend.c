@@ -43,6 +43,13 @@ void renderer_system_shutdown(void* state) {
     state_ptr = 0;    
 }
 
+u8 renderer_max_frames_in_flight() {
+    if (!state_ptr) {
+        return 0;
+    }
+    return state_ptr->backend.max_frames_in_flight;
+}
+
 b8 renderer_begin_frame(f32 delta_time) {
     if (!state_ptr) {
         return false;
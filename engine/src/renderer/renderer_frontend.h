@@ -15,4 +15,7 @@ void renderer_system_shutdown(void* state);
 
 void renderer_on_resized(u16 width, u16 height);
 
+// Frames the CPU may record ahead of the GPU; memory written during a frame may be read by the GPU until then.
+u8 renderer_max_frames_in_flight();
+
 b8 renderer_draw_frame(render_packet* packet);
\ No newline at end of file
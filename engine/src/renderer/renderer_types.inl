@@ -15,8 +15,13 @@ typedef struct global_uniform_object {
     mat4 m_reserved1;   // and so that uniform object is 256 bytes
 } global_uniform_object;
 
+// Uniform buffer offsets must be multiples of minUniformBufferOffsetAlignment, at most 256 bytes
+STATIC_ASSERT(sizeof(global_uniform_object) == 256, "Expected global_uniform_object to be 256 bytes.");
+
 typedef struct renderer_backend {
     u64 frame_number;
+    // Frames the CPU may record ahead of the GPU. Set by initialize.
+    u8 max_frames_in_flight;
 
     b8 (*initialize)(struct renderer_backend* backend, const char* application_name);
 
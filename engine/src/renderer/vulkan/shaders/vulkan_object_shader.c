@@ -2,6 +2,7 @@
 
 #include "core/logger.h"
 #include "core/pe_memory.h"
+#include "core/pe_string.h"
 #include "math/math_types.h"
 
 #include "renderer/vulkan/vulkan_shader_utils.h"
@@ -10,42 +11,33 @@
 
 #define BUILTIN_SHADER_NAME_OBJECT "Builtin.ObjectShader"
 
-b8 vulkan_object_shader_create(vulkan_context* context, vulkan_object_shader* out_shader){
+static void destroy_stage_modules(vulkan_context* context, vulkan_shader_stage* stages) {
+    for (u32 i = 0; i < OBJECT_SHADER_STAGE_COUNT; ++i) {
+        if (stages[i].handle) {
+            vkDestroyShaderModule(context->device.logical_device, stages[i].handle, context->allocator);
+            stages[i].handle = 0;
+        }
+    }
+}
+
+// Loads the modules of every stage. Leaves no modules behind on failure.
+static b8 create_stage_modules(vulkan_context* context, vulkan_shader_stage* stages) {
     // Shader module init per stage
     char stage_type_strs[OBJECT_SHADER_STAGE_COUNT][5] = {"vert", "frag"};
     VkShaderStageFlagBits stage_types[OBJECT_SHADER_STAGE_COUNT] = {VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT};
 
+    pe_zero_memory(stages, sizeof(vulkan_shader_stage) * OBJECT_SHADER_STAGE_COUNT);
     for (u32 i = 0; i < OBJECT_SHADER_STAGE_COUNT; ++i) {
-        if (!create_shader_module(context, BUILTIN_SHADER_NAME_OBJECT, stage_type_strs[i], stage_types[i], i, out_shader->stages)) {
+        if (!create_shader_module(context, BUILTIN_SHADER_NAME_OBJECT, stage_type_strs[i], stage_types[i], i, stages)) {
             PE_ERROR("Unable to create %s shader module for '%s'.", stage_type_strs[i], BUILTIN_SHADER_NAME_OBJECT);
+            destroy_stage_modules(context, stages);
             return false;
         }
     }
+    return true;
+}
 
-    // Global descriptors
-    VkDescriptorSetLayoutBinding global_ubo_layout_binding;
-    global_ubo_layout_binding.binding = 0;
-    global_ubo_layout_binding.descriptorCount = 1;
-    global_ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    global_ubo_layout_binding.pImmutableSamplers = 0;
-    global_ubo_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-
-    VkDescriptorSetLayoutCreateInfo global_layout_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-    global_layout_create_info.bindingCount = 1;
-    global_layout_create_info.pBindings = &global_ubo_layout_binding;
-    VK_CHECK(vkCreateDescriptorSetLayout(context->device.logical_device, &global_layout_create_info, context->allocator, &out_shader->global_descriptor_set_layout));
-
-    VkDescriptorPoolSize global_pool_size;
-    global_pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    global_pool_size.descriptorCount = context->swapchain.image_count;
-
-    VkDescriptorPoolCreateInfo global_pool_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-    global_pool_create_info.poolSizeCount = 1;
-    global_pool_create_info.pPoolSizes = &global_pool_size;
-    global_pool_create_info.maxSets = context->swapchain.image_count;
-    VK_CHECK(vkCreateDescriptorPool(context->device.logical_device, &global_pool_create_info, context->allocator, &out_shader->global_descriptor_pool));
-
-    // Pipeline creation
+static b8 create_pipeline(vulkan_context* context, vulkan_object_shader* shader, vulkan_shader_stage* stages, vulkan_pipeline* out_pipeline) {
     VkViewport viewport;
     viewport.x = 0.0f;
     viewport.y = (f32)context->frame_buffer_height;
@@ -83,7 +75,7 @@ b8 vulkan_object_shader_create(vulkan_context* context, vulkan_object_shader* ou
     // Descriptor set layouts
     const i32 descriptor_set_layout_count = 1;
     VkDescriptorSetLayout layouts[descriptor_set_layout_count] = {
-        out_shader->global_descriptor_set_layout
+        shader->global_descriptor_set_layout
     };
 
 
@@ -93,8 +85,8 @@ b8 vulkan_object_shader_create(vulkan_context* context, vulkan_object_shader* ou
     VkPipelineShaderStageCreateInfo stage_create_infos[OBJECT_SHADER_STAGE_COUNT];
     pe_zero_memory(stage_create_infos, sizeof(stage_create_infos));
     for (u32 i = 0; i < OBJECT_SHADER_STAGE_COUNT; ++i) {
-        stage_create_infos[i].sType = out_shader->stages[i].shader_stage_create_info.sType;
-        stage_create_infos[i] = out_shader->stages[i].shader_stage_create_info;
+        stage_create_infos[i].sType = stages[i].shader_stage_create_info.sType;
+        stage_create_infos[i] = stages[i].shader_stage_create_info;
     }
 
     if (!vulkan_pipeline_create(
@@ -109,12 +101,49 @@ b8 vulkan_object_shader_create(vulkan_context* context, vulkan_object_shader* ou
         viewport,
         scissor,
         false,
-        &out_shader->pipeline
+        out_pipeline
     )) {
         PE_ERROR("Failed to load graphics pipeline for object shader.");
         return false;
     }
 
+    return true;
+
+}
+
+b8 vulkan_object_shader_create(vulkan_context* context, vulkan_object_shader* out_shader){
+    if (!create_stage_modules(context, out_shader->stages)) {
+        return false;
+    }
+
+    // Global descriptors
+    VkDescriptorSetLayoutBinding global_ubo_layout_binding;
+    global_ubo_layout_binding.binding = 0;
+    global_ubo_layout_binding.descriptorCount = 1;
+    global_ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    global_ubo_layout_binding.pImmutableSamplers = 0;
+    global_ubo_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo global_layout_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    global_layout_create_info.bindingCount = 1;
+    global_layout_create_info.pBindings = &global_ubo_layout_binding;
+    VK_CHECK(vkCreateDescriptorSetLayout(context->device.logical_device, &global_layout_create_info, context->allocator, &out_shader->global_descriptor_set_layout));
+
+    VkDescriptorPoolSize global_pool_size;
+    global_pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    global_pool_size.descriptorCount = context->swapchain.image_count;
+
+    VkDescriptorPoolCreateInfo global_pool_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    global_pool_create_info.poolSizeCount = 1;
+    global_pool_create_info.pPoolSizes = &global_pool_size;
+    global_pool_create_info.maxSets = context->swapchain.image_count;
+    VK_CHECK(vkCreateDescriptorPool(context->device.logical_device, &global_pool_create_info, context->allocator, &out_shader->global_descriptor_pool));
+
+    // Pipeline creation
+    if (!create_pipeline(context, out_shader, out_shader->stages, &out_shader->pipeline)) {
+        return false;
+    }
+
     // Create uniform buffer
     if (!vulkan_buffer_create(
         context,
@@ -163,10 +192,46 @@ void vulkan_object_shader_destroy(vulkan_context* context, struct vulkan_object_
     vkDestroyDescriptorSetLayout(context->device.logical_device, shader->global_descriptor_set_layout, context->allocator);
 
     // Destroy shader modules
+    destroy_stage_modules(context, shader->stages);
+}
+
+b8 vulkan_object_shader_uses_file(const char* file_name) {
+    // Stage binaries are named <shader name>.<stage>.spv
+    u64 name_length = string_length(BUILTIN_SHADER_NAME_OBJECT);
+    return string_length(file_name) > name_length &&
+           strings_equal_n(file_name, BUILTIN_SHADER_NAME_OBJECT, name_length) &&
+           file_name[name_length] == '.';
+}
+
+b8 vulkan_object_shader_reload(vulkan_context* context, struct vulkan_object_shader* shader) {
+    // Build the replacements first, so a broken shader leaves the current pipeline running
+    vulkan_shader_stage stages[OBJECT_SHADER_STAGE_COUNT];
+    if (!create_stage_modules(context, stages)) {
+        PE_ERROR("Object shader reload failed, keeping the current pipeline.");
+        return false;
+    }
+
+    vulkan_pipeline pipeline;
+    if (!create_pipeline(context, shader, stages, &pipeline)) {
+        PE_ERROR("Object shader reload failed, keeping the current pipeline.");
+        destroy_stage_modules(context, stages);
+        return false;
+    }
+
+    vulkan_pipeline_destroy(context, &shader->pipeline);
+    destroy_stage_modules(context, shader->stages);
+    shader->pipeline = pipeline;
     for (u32 i = 0; i < OBJECT_SHADER_STAGE_COUNT; ++i) {
-        vkDestroyShaderModule(context->device.logical_device, shader->stages[i].handle, context->allocator);
-        shader->stages[i].handle = 0;
+        shader->stages[i] = stages[i];
+    }
+
+    // Descriptor sets are bound against the pipeline layout, so bind them again on next use
+    for (u32 i = 0; i < 3; ++i) {
+        shader->descriptor_updated[i] = false;
     }
+
+    PE_INFO("Object shader reloaded.");
+    return true;
 }
 
 void vulkan_object_shader_use(vulkan_context* context, struct vulkan_object_shader* shader){
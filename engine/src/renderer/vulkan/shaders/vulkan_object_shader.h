@@ -9,4 +9,11 @@ void vulkan_object_shader_destroy(vulkan_context* context, struct vulkan_object_
 
 void vulkan_object_shader_use(vulkan_context* context, struct vulkan_object_shader* shader);
 
-void vulkan_object_shader_update_global_state(vulkan_context* context, struct vulkan_object_shader* shader);
\ No newline at end of file
+void vulkan_object_shader_update_global_state(vulkan_context* context, struct vulkan_object_shader* shader);
+
+// True if file_name is one of the stage binaries of the object shader.
+b8 vulkan_object_shader_uses_file(const char* file_name);
+
+// Rebuilds the shader modules and pipeline from disk. The GPU must be done with the current
+// pipeline. On failure the current pipeline is kept.
+b8 vulkan_object_shader_reload(vulkan_context* context, struct vulkan_object_shader* shader);
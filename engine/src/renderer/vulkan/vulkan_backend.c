@@ -10,13 +10,16 @@
 #include "vulkan_fence.h"
 #include "vulkan_utils.h"
 #include "vulkan_buffer.h"
+#include "vulkan_host_allocator.h"
 
 #include "core/logger.h"
 #include "core/pe_string.h"
 #include "core/pe_memory.h"
 #include "core/application.h"
+#include "core/event.h"
 
 #include "containers/darray.h"
+#include "containers/hashtable.h"
 
 #include "math/math_types.h"
 
@@ -40,6 +43,10 @@ i32 find_memory_index(u32 type_filter, u32 property_flags);
 b8 create_buffers(vulkan_context* context);
 
 void create_command_buffers(renderer_backend* backend);
+b8 vulkan_on_file_changed(u16 code, void* sender, void* listener_inst, event_context context);
+void create_timestamp_queries(vulkan_context* context);
+void read_timestamp_queries(vulkan_context* context, u32 frame);
+
 void regenerate_frame_buffers(renderer_backend* backend, vulkan_swapchain* swapchain, vulkan_render_pass* render_pass);
 b8 recreate_swapchain(renderer_backend* backend);
 
@@ -62,8 +69,13 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
     // Function pointers
     context.find_memory_index = find_memory_index;
 
-    // TODO: custom allocator
+    // Route the driver's host allocations through the engine heap, so they show up in the memory stats
     context.allocator = 0;
+    if (vulkan_host_allocator_create(&context.host_allocator)) {
+        context.allocator = &context.host_allocator.callbacks;
+    } else {
+        PE_WARN("Failed to create the Vulkan host allocator; using the driver's own.");
+    }
 
     
     application_get_frame_buffer_size(&cached_frame_buffer_width, &cached_frame_buffer_height);
@@ -85,10 +97,12 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 
     // Obtain a list of required extensions
     const char** required_extensions = darray_create(const char*);
-    darray_push(required_extensions, &VK_KHR_SURFACE_EXTENSION_NAME);   // Generic surface extension
+#if !PE_HEADLESS
+    darray_push(required_extensions, VK_KHR_SURFACE_EXTENSION_NAME);   // Generic surface extension
+#endif
     platform_get_required_extension_names(&required_extensions);        // Platform-specifin extension
     #if defined(_DEBUG)
-        darray_push(required_extensions, &VK_EXT_DEBUG_UTILS_EXTENSION_NAME); // debug utillities
+        darray_push(required_extensions, VK_EXT_DEBUG_UTILS_EXTENSION_NAME); // debug utillities
     
         PE_DEBUG("Required extensions");
         u32 length = darray_length(required_extensions);
@@ -111,7 +125,7 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 
         // The list of validation layers required
         required_validation_layer_names = darray_create(const char*);
-        darray_push(required_validation_layer_names, &"VK_LAYER_KHRONOS_validation");
+        darray_push(required_validation_layer_names, "VK_LAYER_KHRONOS_validation");
         required_validation_layer_count = darray_length(required_validation_layer_names);
         
         // Obtain a list of available validation layers
@@ -120,22 +134,22 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
         VkLayerProperties* available_layers = darray_reserve(VkLayerProperties, available_layer_count);
         VK_CHECK(vkEnumerateInstanceLayerProperties(&available_layer_count, available_layers));
 
-        // Verify all required layers are available
+        // Index the available layers by name, then verify all required layers are among them
+        hashtable available_layer_table;
+        hashtable_create(0, available_layer_count, &available_layer_table);
+        for (u32 j = 0; j < available_layer_count; ++j) {
+            hashtable_set(&available_layer_table, available_layers[j].layerName, 0);
+        }
+
         for (u32 i = 0; i < required_validation_layer_count; ++i) {
             PE_INFO("Searching for layer: %s...", required_validation_layer_names[i]);
-            b8 found = false;
-            for (u32 j = 0; j < available_layer_count; ++j) {
-                if (strings_equal(required_validation_layer_names[i], available_layers[j].layerName)) {
-                    found = true;
-                    PE_INFO("Found");
-                    break;
-                }
-            }
-
-            if (!found) {
+            if (!hashtable_contains(&available_layer_table, required_validation_layer_names[i])) {
                 PE_FATAL("Required validation layer is missing: %s", required_validation_layer_names[i]);
+            } else {
+                PE_INFO("Found");
             }
         }
+        hashtable_destroy(&available_layer_table);
         PE_INFO("All required validation layers are present");
     #endif
 
@@ -217,6 +231,7 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
         // cannot be rendered until a frame is "rendered" before it.
         vulkan_fence_create(&context, true, &context.in_flight_fences[i]);
     }
+    backend->max_frames_in_flight = context.swapchain.max_frames_in_flight;
 
     // In flight fences should not yet exist at this point, so clear the list. These are stored in pointers
     // because the initial state should be 0, and will be 0 when not in use. Actual fences are not owned
@@ -227,11 +242,16 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
     }
     PE_INFO("Vulkan sync objects created");
 
+    // GPU frame timing
+    create_timestamp_queries(&context);
+
     // Create builtin shaders
     if (!vulkan_object_shader_create(&context, &context.object_shader)) {
         PE_ERROR("Error loading built-in basic_lighting shader.");
         return false;
     }
+    context.object_shader_reload_pending = false;
+    event_register(EVENT_CODE_FILE_CHANGED, 0, vulkan_on_file_changed);
 
     // Create buffers
     create_buffers(&context);
@@ -298,8 +318,21 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend) {
     vulkan_buffer_destroy(&context, &context.object_index_buffer);
 
     // Shader modules
+    event_unregister(EVENT_CODE_FILE_CHANGED, 0, vulkan_on_file_changed);
     vulkan_object_shader_destroy(&context, &context.object_shader);
 
+    // GPU frame timing
+    if (context.gpu_timed_frame_count > 0) {
+        PE_INFO(
+            "GPU frame time: %.3f ms average over %llu frames.",
+            context.gpu_time_total_ms / context.gpu_timed_frame_count,
+            context.gpu_timed_frame_count);
+    }
+    if (context.timestamp_query_pool) {
+        vkDestroyQueryPool(context.device.logical_device, context.timestamp_query_pool, context.allocator);
+        context.timestamp_query_pool = 0;
+    }
+
     // Sync objects
     for (u8 i = 0; i < context.swapchain.max_frames_in_flight; ++i) {
         if (context.image_available_semaphores[i]) {
@@ -378,6 +411,9 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend) {
 
     PE_DEBUG("Destroying Vulkan instance...");
     vkDestroyInstance(context.instance, context.allocator);
+
+    vulkan_host_allocator_destroy(&context.host_allocator);
+    context.allocator = 0;
 }
 
 void vulkan_renderer_backend_begin_on_resized(renderer_backend* backend, u16 width, u16 height) {
@@ -422,6 +458,17 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
         return false;
     }
 
+    // Swap in shaders edited on disk. Only the affected pipeline is rebuilt.
+    if (context.object_shader_reload_pending) {
+        context.object_shader_reload_pending = false;
+        VkResult result = vkDeviceWaitIdle(device->logical_device);
+        if (!vulkan_result_is_success(result)) {
+            PE_ERROR("vulkan_renderer_backend_begin_frame vkDeviceWaitIdle (3) failed: '%s'", vulkan_result_string(result, true));
+            return false;
+        }
+        vulkan_object_shader_reload(&context, &context.object_shader);
+    }
+
     // Wait for the execution of the current frame to complete. The fence being free will allow this one to move on
     if (!vulkan_fence_wait(
         &context,
@@ -432,6 +479,9 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
         return false;
     }
 
+    // The previous submission for this frame has completed, so its timestamps are available
+    read_timestamp_queries(&context, context.current_frame);
+
     // Acquire the next image from the swap chain. Pass along the semaphore that should signaled when this completes.
     /// The same semaphore will later be waited on by the queue submission to ensure this image is available
     if (!vulkan_swapchain_acquire_next_image_index(
@@ -450,6 +500,12 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     vulkan_command_buffer_reset(command_buffer);
     vulkan_command_buffer_begin(command_buffer, false, false, false);
 
+    if (context.timestamp_query_pool) {
+        u32 first_query = context.current_frame * 2;
+        vkCmdResetQueryPool(command_buffer->handle, context.timestamp_query_pool, first_query, 2);
+        vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, context.timestamp_query_pool, first_query);
+    }
+
     // Dynamic state
     VkViewport viewport;
     viewport.x= 0.0f;
@@ -516,6 +572,11 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time){
     // End render pass
     vulkan_render_pass_end(command_buffer, &context.main_render_pass);
 
+    if (context.timestamp_query_pool) {
+        vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, context.timestamp_query_pool, context.current_frame * 2 + 1);
+        context.timestamps_pending_mask |= (1u << context.current_frame);
+    }
+
     vulkan_command_buffer_end(command_buffer);
 
     // Make sure the previous frame is not using this image (i.e. its fence is being waited on)
@@ -542,11 +603,12 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time){
     submit_info.pCommandBuffers = &command_buffer->handle;
 
     // The semaphore(s) to be signaled when the queue is complete
-    submit_info.signalSemaphoreCount = 1;
+    // Offscreen targets are neither acquired nor presented, so there is nothing to signal or wait on.
+    submit_info.signalSemaphoreCount = context.swapchain.is_offscreen ? 0 : 1;
     submit_info.pSignalSemaphores = &context.queue_complete_semaphores[context.current_frame];
 
     // Wait semaphore ensures that the operation cannot begin until the image is available
-    submit_info.waitSemaphoreCount = 1;
+    submit_info.waitSemaphoreCount = context.swapchain.is_offscreen ? 0 : 1;
     submit_info.pWaitSemaphores = &context.image_available_semaphores[context.current_frame];
 
     // Each semaphore waits on the corresponding pipeline stage to complete, 1:1 ratio.
@@ -698,11 +760,13 @@ b8 recreate_swapchain(renderer_backend* backend) {
     }
 
     // Requery support
-    vulkan_device_query_swapchain_support(
-        context.device.physical_device,
-        context.surface,
-        &context.device.swapchain_support
-    );
+    if (context.surface) {
+        vulkan_device_query_swapchain_support(
+            context.device.physical_device,
+            context.surface,
+            &context.device.swapchain_support
+        );
+    }
     vulkan_device_detect_depth_format(&context.device);
 
     // Recreate swapchain
@@ -782,4 +846,62 @@ b8 create_buffers(vulkan_context* context) {
     context->geometry_index_offset = 0;
 
     return true;
-}
\ No newline at end of file
+}
+
+b8 vulkan_on_file_changed(u16 code, void* sender, void* listener_inst, event_context data) {
+    const char* file_name = (const char*)data.data.u64[1];
+    if (vulkan_object_shader_uses_file(file_name)) {
+        // Reloaded at the start of the next frame, when no command buffer is being recorded
+        PE_DEBUG("Shader '%s' changed, reloading.", file_name);
+        context.object_shader_reload_pending = true;
+        return true;
+    }
+
+    // Let other listeners see it
+    return false;
+}
+
+void create_timestamp_queries(vulkan_context* context) {
+    context->timestamp_query_pool = 0;
+    if (!context->device.properties.limits.timestampComputeAndGraphics) {
+        PE_INFO("Device does not support timestamps, GPU frame timing disabled.");
+        return;
+    }
+
+    // Begin/end timestamp for every frame in flight
+    u32 frame_count = context->swapchain.max_frames_in_flight;
+    VkQueryPoolCreateInfo query_pool_create_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    query_pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    query_pool_create_info.queryCount = frame_count * 2;
+    VK_CHECK(vkCreateQueryPool(context->device.logical_device, &query_pool_create_info, context->allocator, &context->timestamp_query_pool));
+
+    context->timestamps_pending_mask = 0;
+    context->gpu_timed_frame_count = 0;
+    context->gpu_time_total_ms = 0;
+}
+
+void read_timestamp_queries(vulkan_context* context, u32 frame) {
+    if (!context->timestamp_query_pool || !(context->timestamps_pending_mask & (1u << frame))) {
+        return;
+    }
+
+    u64 timestamps[2];
+    VkResult result = vkGetQueryPoolResults(
+        context->device.logical_device,
+        context->timestamp_query_pool,
+        frame * 2,
+        2,
+        sizeof(timestamps),
+        timestamps,
+        sizeof(u64),
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return;
+    }
+    context->timestamps_pending_mask &= ~(1u << frame);
+
+    // timestampPeriod is the number of nanoseconds per timestamp tick
+    f64 elapsed_ms = (timestamps[1] - timestamps[0]) * (f64)context->device.properties.limits.timestampPeriod / 1000000.0;
+    context->gpu_time_total_ms += elapsed_ms;
+    context->gpu_timed_frame_count++;
+}
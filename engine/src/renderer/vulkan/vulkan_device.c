@@ -86,7 +86,8 @@ b8 vulkan_device_create(vulkan_context* context){
     device_create_info.pQueueCreateInfos = queue_create_info;
     device_create_info.pEnabledFeatures = &device_features;
 
-    device_create_info.enabledExtensionCount = 1;
+    // The swapchain extension is only needed (and only guaranteed) when presenting to a surface
+    device_create_info.enabledExtensionCount = context->surface ? 1 : 0;
     const char* extension_names = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
     device_create_info.ppEnabledExtensionNames = &extension_names;
 
@@ -299,15 +300,20 @@ b8 select_physical_device(vulkan_context* context){
 
         // TODO: These requirements should be driven by engine configuration
         vulkan_physical_device_requirements requirements = {};
+        // NOTE: Headless runs (no surface) accept any device, e.g. a software rasterizer,
+        // and have nothing to present to.
+        b8 has_surface = context->surface != 0;
         requirements.graphics = true;
-        requirements.present = true;
+        requirements.present = has_surface;
         requirements.transfer = true;
         // NOTE: enable this if compute will be required.
         //requirements.compute = true;
         requirements.sampler_anisotropy = true;
-        requirements.discrete_gpu = true;
+        requirements.discrete_gpu = has_surface;
         requirements.device_extension_names = darray_create(const char*);
-        darray_push(requirements.device_extension_names, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        if (has_surface) {
+            darray_push(requirements.device_extension_names, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
 
         vulkan_physical_device_queue_family_info queue_info = {};
         b8 result = physical_device_meets_requirements(
@@ -367,7 +373,8 @@ b8 select_physical_device(vulkan_context* context){
 
             context->device.physical_device = physical_devices[i];
             context->device.graphics_queue_index = queue_info.graphics_family_index;
-            context->device.present_queue_index = queue_info.present_family_index;
+            // Without a surface nothing is presented; alias the graphics queue
+            context->device.present_queue_index = has_surface ? queue_info.present_family_index : queue_info.graphics_family_index;
             context->device.transfer_queue_index = queue_info.transfer_family_index;
             // NOTE: set compute index here if needed.
 
@@ -445,10 +452,12 @@ b8 physical_device_meets_requirements(
         }
 
         // Present queue?
-        VkBool32 supports_present = VK_FALSE;
-        VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &supports_present));
-        if (supports_present) {
-            out_queue_info->present_family_index = i;
+        if (requirements->present) {
+            VkBool32 supports_present = VK_FALSE;
+            VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &supports_present));
+            if (supports_present) {
+                out_queue_info->present_family_index = i;
+            }
         }
     }
 
@@ -473,14 +482,16 @@ b8 physical_device_meets_requirements(
         PE_TRACE("Transfer Family Index: %i", out_queue_info->transfer_family_index);
         PE_TRACE("Compute Family Index: %i", out_queue_info->compute_family_index);
             
-        // Query swapchain support.
-        vulkan_device_query_swapchain_support(
-            device,
-            surface,
-            out_swapchain_support
-        );
+        // Query swapchain support, if there is anything to present to.
+        if (requirements->present) {
+            vulkan_device_query_swapchain_support(
+                device,
+                surface,
+                out_swapchain_support
+            );
+        }
 
-        if (out_swapchain_support->format_count < 1 || out_swapchain_support->present_mode_count < 1) {
+        if (requirements->present && (out_swapchain_support->format_count < 1 || out_swapchain_support->present_mode_count < 1)) {
             if (out_swapchain_support->formats) {
                 pe_free(out_swapchain_support->formats, sizeof(VkSurfaceFormatKHR) * out_swapchain_support->format_count, MEMORY_TAG_RENDERER);
             }
@@ -0,0 +1,187 @@
+#include "vulkan_host_allocator.h"
+
+#include "core/logger.h"
+#include "core/pe_memory.h"
+
+#define COMMAND_ARENA_SIZE (256 * 1024)
+
+// The largest alignment pe_allocate_aligned can honour
+#define MAX_ALIGNMENT 32768
+
+// Stored just in front of every block handed to Vulkan
+typedef struct allocation_header {
+    // Size requested by the driver
+    u64 size;
+    // Distance from the start of the underlying allocation to the block
+    u32 offset;
+    u16 alignment;
+    u8 tag;
+    b8 in_command_arena;
+} allocation_header;
+
+static memory_tag scope_tag(VkSystemAllocationScope scope) {
+    switch (scope) {
+        case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:
+            return MEMORY_TAG_VULKAN_COMMAND;
+        case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:
+            return MEMORY_TAG_VULKAN_CACHE;
+        case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+            return MEMORY_TAG_VULKAN_DEVICE;
+        case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+            return MEMORY_TAG_VULKAN_INSTANCE;
+        case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:
+        default:
+            return MEMORY_TAG_VULKAN_OBJECT;
+    }
+}
+
+// Bumps a block out of the command arena. Returns 0 if it doesn't fit.
+static u8* command_arena_allocate(vulkan_host_allocator* allocator, u64 size, u16 alignment) {
+    u8* block = 0;
+    platform_mutex_lock(&allocator->command_arena_mutex);
+    linear_allocator* arena = &allocator->command_arena;
+    // Worst case padding included, so a full arena falls back quietly instead of logging an error
+    if (arena->allocated + size + alignment <= arena->total_size) {
+        block = linear_allocator_allocate_aligned(arena, size, alignment);
+        allocator->command_arena_live_count++;
+    } else {
+        allocator->command_arena_overflow_count++;
+    }
+    platform_mutex_unlock(&allocator->command_arena_mutex);
+    return block;
+}
+
+static void command_arena_free(vulkan_host_allocator* allocator) {
+    platform_mutex_lock(&allocator->command_arena_mutex);
+    allocator->command_arena_live_count--;
+    if (allocator->command_arena_live_count == 0) {
+        linear_allocator_free_all(&allocator->command_arena, false);
+    }
+    platform_mutex_unlock(&allocator->command_arena_mutex);
+}
+
+static void* VKAPI_CALL vulkan_host_allocate(void* user_data, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    if (size == 0) {
+        return 0;
+    }
+    if (alignment > MAX_ALIGNMENT) {
+        PE_ERROR("Vulkan requested a host allocation aligned to %lluB; at most %u is supported.", (u64)alignment, MAX_ALIGNMENT);
+        return 0;
+    }
+
+    vulkan_host_allocator* allocator = user_data;
+    u16 block_alignment = alignment < sizeof(allocation_header) ? sizeof(allocation_header) : (u16)alignment;
+    u64 offset = pe_align_up(sizeof(allocation_header), block_alignment);
+    u64 total_size = offset + size;
+    memory_tag tag = scope_tag(scope);
+
+    u8* base = 0;
+    b8 in_command_arena = false;
+    if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND) {
+        base = command_arena_allocate(allocator, total_size, block_alignment);
+        in_command_arena = base != 0;
+    }
+    if (!base) {
+        // Drivers don't expect zeroed memory, so skip clearing it
+        base = pe_allocate_aligned_uninit(total_size, block_alignment, tag);
+        if (!base) {
+            return 0;
+        }
+    }
+
+    u8* block = base + offset;
+    allocation_header* header = (allocation_header*)block - 1;
+    header->size = size;
+    header->offset = (u32)offset;
+    header->alignment = block_alignment;
+    header->tag = (u8)tag;
+    header->in_command_arena = in_command_arena;
+    return block;
+}
+
+static void VKAPI_CALL vulkan_host_free(void* user_data, void* memory) {
+    if (!memory) {
+        return;
+    }
+
+    allocation_header* header = (allocation_header*)memory - 1;
+    if (header->in_command_arena) {
+        command_arena_free(user_data);
+        return;
+    }
+
+    pe_free_aligned((u8*)memory - header->offset, header->offset + header->size, header->alignment, (memory_tag)header->tag);
+}
+
+static void* VKAPI_CALL vulkan_host_reallocate(void* user_data, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    if (!original) {
+        return vulkan_host_allocate(user_data, size, alignment, scope);
+    }
+    if (size == 0) {
+        vulkan_host_free(user_data, original);
+        return 0;
+    }
+
+    // The original must stay intact if the new allocation fails
+    void* block = vulkan_host_allocate(user_data, size, alignment, scope);
+    if (!block) {
+        return 0;
+    }
+
+    allocation_header* header = (allocation_header*)original - 1;
+    pe_copy_memory(block, original, header->size < size ? header->size : size);
+    vulkan_host_free(user_data, original);
+    return block;
+}
+
+static void VKAPI_CALL vulkan_host_internal_allocation(void* user_data, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+    vulkan_host_allocator* allocator = user_data;
+    PE_ATOMIC_FETCH_ADD(&allocator->internal_allocated, size, PE_ATOMIC_RELAXED);
+}
+
+static void VKAPI_CALL vulkan_host_internal_free(void* user_data, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+    vulkan_host_allocator* allocator = user_data;
+    PE_ATOMIC_FETCH_SUB(&allocator->internal_allocated, size, PE_ATOMIC_RELAXED);
+}
+
+b8 vulkan_host_allocator_create(vulkan_host_allocator* out_allocator) {
+    pe_zero_memory(out_allocator, sizeof(vulkan_host_allocator));
+
+    void* arena_memory = pe_allocate_uninit(COMMAND_ARENA_SIZE, MEMORY_TAG_VULKAN_COMMAND);
+    if (!arena_memory) {
+        return false;
+    }
+    if (!platform_mutex_create(&out_allocator->command_arena_mutex)) {
+        pe_free(arena_memory, COMMAND_ARENA_SIZE, MEMORY_TAG_VULKAN_COMMAND);
+        return false;
+    }
+    linear_allocator_create(COMMAND_ARENA_SIZE, arena_memory, &out_allocator->command_arena);
+
+    out_allocator->callbacks.pUserData = out_allocator;
+    out_allocator->callbacks.pfnAllocation = vulkan_host_allocate;
+    out_allocator->callbacks.pfnReallocation = vulkan_host_reallocate;
+    out_allocator->callbacks.pfnFree = vulkan_host_free;
+    out_allocator->callbacks.pfnInternalAllocation = vulkan_host_internal_allocation;
+    out_allocator->callbacks.pfnInternalFree = vulkan_host_internal_free;
+    return true;
+}
+
+void vulkan_host_allocator_destroy(vulkan_host_allocator* allocator) {
+    if (!allocator->command_arena.memory) {
+        return;
+    }
+
+    if (allocator->command_arena_live_count > 0) {
+        PE_WARN("Vulkan host allocator destroyed with %llu command scope allocations still live.", allocator->command_arena_live_count);
+    }
+    PE_DEBUG(
+        "Vulkan host allocator: %llu command scope allocations overflowed the arena, %lluB driver internal memory outstanding.",
+        allocator->command_arena_overflow_count,
+        allocator->internal_allocated);
+
+    void* arena_memory = allocator->command_arena.memory;
+    linear_allocator_destroy(&allocator->command_arena);
+    pe_free(arena_memory, COMMAND_ARENA_SIZE, MEMORY_TAG_VULKAN_COMMAND);
+    platform_mutex_destroy(&allocator->command_arena_mutex);
+    pe_zero_memory(allocator, sizeof(vulkan_host_allocator));
+}
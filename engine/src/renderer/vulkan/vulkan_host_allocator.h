@@ -0,0 +1,20 @@
+#pragma once
+
+#include "vulkan_types.inl"
+
+/**
+ * @brief Sets up host memory callbacks that route the driver's CPU-side allocations through
+ * the engine heap, tagged by allocation scope, so they show up in the memory stats.
+ *
+ * Command scope allocations are bumped out of a small arena instead. The arena is only rewound
+ * once every block in it has been freed, not per frame, so a command scope allocation the driver
+ * holds on to keeps the arena from being reused. Once it fills, further command scope allocations
+ * go to the heap and are counted in command_arena_overflow_count.
+ *
+ * @param out_allocator A pointer to hold the allocator. Must stay at the same address while in use.
+ * @returns True on success; otherwise false.
+ */
+PE_API b8 vulkan_host_allocator_create(vulkan_host_allocator* out_allocator);
+
+// Destroys the allocator. Call after the Vulkan instance has been destroyed.
+PE_API void vulkan_host_allocator_destroy(vulkan_host_allocator* allocator);
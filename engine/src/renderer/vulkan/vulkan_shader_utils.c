@@ -19,27 +19,21 @@ b8 create_shader_module(
     // TODO: configurable path
     string_format(file_name, "assets/shaders/%s.%s.spv", name, type_str);
 
-    pe_zero_memory(&shader_stages[stage_index].create_info, sizeof(VkShaderModuleCreateFlags));
+    pe_zero_memory(&shader_stages[stage_index].create_info, sizeof(VkShaderModuleCreateInfo));
     shader_stages[stage_index].create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 
-    file_handle file;
-    if (!filesystem_open(file_name, FILE_MODE_READ, true, &file)) {
+    // Map the SPIR-V binary; the driver copies it during module creation, so no heap copy is needed
+    file_mapping mapping;
+    if (!filesystem_map(file_name, FILE_MAP_HINT_SEQUENTIAL | FILE_MAP_HINT_WILLNEED, &mapping)) {
         PE_ERROR("Unable to read shader module: '%s'.", file_name);
         return false;
     }
-
-    // Read the entier file as binary
-    u64 size = 0;
-    u8* file_buffer = 0;
-    if (!filesystem_read_all_bytes(&file, &file_buffer, &size)) {
-        PE_ERROR("Unable to binary read shader module: '%s'.", file_name);
+    if (!mapping.size) {
+        PE_ERROR("Shader module is empty: '%s'.", file_name);
         return false;
     }
-    shader_stages[stage_index].create_info.codeSize = size;
-    shader_stages[stage_index].create_info.pCode = (u32*)file_buffer;
-
-    // Close the file
-    filesystem_close(&file);
+    shader_stages[stage_index].create_info.codeSize = mapping.size;
+    shader_stages[stage_index].create_info.pCode = (const u32*)mapping.data;
 
     VK_CHECK(vkCreateShaderModule(
         context->device.logical_device,
@@ -48,6 +42,9 @@ b8 create_shader_module(
         &shader_stages[stage_index].handle
     ));
 
+    filesystem_unmap(&mapping);
+    shader_stages[stage_index].create_info.pCode = 0;
+
     // Shader stage info
     pe_zero_memory(&shader_stages[stage_index].shader_stage_create_info, sizeof(VkPipelineShaderStageCreateInfo));
     shader_stages[stage_index].shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -55,10 +52,5 @@ b8 create_shader_module(
     shader_stages[stage_index].shader_stage_create_info.module = shader_stages[stage_index].handle;
     shader_stages[stage_index].shader_stage_create_info.pName = "main";
 
-    if (!file_buffer) {
-        pe_free(file_buffer, sizeof(u8) * size, MEMORY_TAG_STRING);
-        file_buffer = 0;
-    }
-
     return true;
 }
\ No newline at end of file
@@ -5,9 +5,15 @@
 #include "vulkan_device.h"
 #include "vulkan_image.h"
 
+// Number of offscreen render targets used in place of swapchain images when headless
+#define OFFSCREEN_IMAGE_COUNT 3
+
 void swapchain_create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* swapchain);
 void swapchain_destroy(vulkan_context* context, vulkan_swapchain* swapchain);
 
+void surface_images_create(vulkan_context* context, VkExtent2D* extent, vulkan_swapchain* swapchain);
+void offscreen_images_create(vulkan_context* context, VkExtent2D* extent, vulkan_swapchain* swapchain);
+
 void vulkan_swapchain_create(
     vulkan_context* context,
     u32 width,
@@ -45,6 +51,13 @@ b8 vulkan_swapchain_acquire_next_image_index(
     VkFence fence,
     u32* out_image_index
 ) {
+    if (swapchain->is_offscreen) {
+        // Offscreen targets are always available; cycle through them. Nothing waits on
+        // image_available_semaphore in this mode, so it is left unsignaled.
+        *out_image_index = (context->image_index + 1) % swapchain->image_count;
+        return true;
+    }
+
     VkResult result = vkAcquireNextImageKHR(context->device.logical_device,
         swapchain->handle,
         timeout_ns,
@@ -75,6 +88,12 @@ void vulkan_swapchain_present(
     VkSemaphore render_complete_semaphore,
     u32 present_image_index
 ) {
+    if (swapchain->is_offscreen) {
+        // Nothing to present, just move on to the next frame
+        context->current_frame = (context->current_frame + 1) % swapchain->max_frames_in_flight;
+        return;
+    }
+
     // Return the image to the swapchain for presentation
     VkPresentInfoKHR present_info = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
     present_info.waitSemaphoreCount = 1;
@@ -101,6 +120,42 @@ void vulkan_swapchain_present(
 void swapchain_create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* swapchain){
     VkExtent2D swapchain_extent = {width, height};
 
+    // Without a surface (headless), render into plain images instead
+    swapchain->is_offscreen = context->surface == 0;
+    if (swapchain->is_offscreen) {
+        offscreen_images_create(context, &swapchain_extent, swapchain);
+    } else {
+        surface_images_create(context, &swapchain_extent, swapchain);
+    }
+
+    // Depth resources
+    if (!vulkan_device_detect_depth_format(&context->device)) {
+        context->device.depth_format = VK_FORMAT_UNDEFINED;
+        PE_FATAL("Failed to find a supported format!");
+    }
+
+    // Create depth image and its view
+    vulkan_image_create(
+        context,
+        VK_IMAGE_TYPE_2D,
+        swapchain_extent.width,
+        swapchain_extent.height,
+        context->device.depth_format,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        true,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        &swapchain->depth_attachment
+    );
+
+    PE_INFO("Swapchain created succesfully!");
+
+}
+
+void surface_images_create(vulkan_context* context, VkExtent2D* extent, vulkan_swapchain* swapchain) {
+    VkExtent2D swapchain_extent = *extent;
+
     // Choose a swap surface format
     b8 found = false;
     for (u32 i = 0; i < context->device.swapchain_support.format_count; ++i) {
@@ -215,37 +270,68 @@ void swapchain_create(vulkan_context* context, u32 width, u32 height, vulkan_swa
         view_info.subresourceRange.layerCount = 1;
 
         VK_CHECK(vkCreateImageView(context->device.logical_device, &view_info, context->allocator, &swapchain->views[i]));
-    }    
-
-    // Depth resources
-    if (!vulkan_device_detect_depth_format(&context->device)) {
-        context->device.depth_format = VK_FORMAT_UNDEFINED;
-        PE_FATAL("Failed to find a supported format!");
     }
 
-    // Create depth image and its view
-    vulkan_image_create(
-        context,
-        VK_IMAGE_TYPE_2D,
-        swapchain_extent.width,
-        swapchain_extent.height,
-        context->device.depth_format,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        true,
-        VK_IMAGE_ASPECT_DEPTH_BIT,
-        &swapchain->depth_attachment
-    );
+    *extent = swapchain_extent;
+}
 
-    PE_INFO("Swapchain created succesfully!");
+void offscreen_images_create(vulkan_context* context, VkExtent2D* extent, vulkan_swapchain* swapchain) {
+    swapchain->image_format.format = VK_FORMAT_B8G8R8A8_UNORM;
+    swapchain->image_format.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 
+    swapchain->image_count = OFFSCREEN_IMAGE_COUNT;
+    swapchain->max_frames_in_flight = OFFSCREEN_IMAGE_COUNT - 1;
+    swapchain->handle = 0;
+
+    // Start with a zero frame index
+    context->current_frame = 0;
+
+    if (!swapchain->offscreen_images) {
+        swapchain->offscreen_images = (vulkan_image*)pe_allocate(sizeof(vulkan_image) * swapchain->image_count, MEMORY_TAG_RENDERER);
+    }
+    if (!swapchain->images) {
+        swapchain->images = (VkImage*)pe_allocate(sizeof(VkImage) * swapchain->image_count, MEMORY_TAG_RENDERER);
+    }
+    if (!swapchain->views) {
+        swapchain->views = (VkImageView*)pe_allocate(sizeof(VkImageView) * swapchain->image_count, MEMORY_TAG_RENDERER);
+    }
+
+    // Colour targets. Transfer source so frames can be read back for inspection.
+    for (u32 i = 0; i < swapchain->image_count; ++i) {
+        vulkan_image_create(
+            context,
+            VK_IMAGE_TYPE_2D,
+            extent->width,
+            extent->height,
+            swapchain->image_format.format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            true,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            &swapchain->offscreen_images[i]
+        );
+        swapchain->images[i] = swapchain->offscreen_images[i].handle;
+        swapchain->views[i] = swapchain->offscreen_images[i].view;
+    }
+
+    PE_INFO("Offscreen render targets created (%ux%u).", extent->width, extent->height);
 }
 
 void swapchain_destroy(vulkan_context* context, vulkan_swapchain* swapchain){
     vkDeviceWaitIdle(context->device.logical_device);
     vulkan_image_destroy(context, &swapchain->depth_attachment);
 
+    if (swapchain->is_offscreen) {
+        // Offscreen images are owned here, so destroy them along with their views
+        for (u32 i = 0; i < swapchain->image_count; ++i) {
+            vulkan_image_destroy(context, &swapchain->offscreen_images[i]);
+            swapchain->images[i] = 0;
+            swapchain->views[i] = 0;
+        }
+        return;
+    }
+
     // Only destroy the views, not the images, since those are owned by the swapchain and are thus
     // destroyed with it
     for (u32 i = 0; i < swapchain->image_count; ++i) {
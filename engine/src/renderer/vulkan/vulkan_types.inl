@@ -4,6 +4,8 @@
 #include "core/asserts.h"
 
 #include "renderer/renderer_types.inl"
+#include "memory/linear_allocator.h"
+#include "platform/platform.h"
 
 #include <vulkan/vulkan.h>
 
@@ -100,6 +102,11 @@ typedef struct vulkan_swapchain {
 
     // darray of framebuffers used for on-screen rendering
     vulkan_frame_buffer* frame_buffers;
+
+    // Set when there is no surface (headless). The images/views above then
+    // belong to offscreen_images instead of a VkSwapchainKHR.
+    b8 is_offscreen;
+    vulkan_image* offscreen_images;
 } vulkan_swapchain;
 
 typedef enum vulkan_command_buffer_state {
@@ -157,6 +164,21 @@ typedef struct vulkan_object_shader {
 
 } vulkan_object_shader;
 
+// Host memory callbacks handed to Vulkan, backed by the engine heap
+typedef struct vulkan_host_allocator {
+    VkAllocationCallbacks callbacks;
+    // Command scope allocations only live for the duration of a single Vulkan call, so they are
+    // bumped out of an arena that is rewound whenever none of them are live. Not reset per frame;
+    // see vulkan_host_allocator_create.
+    linear_allocator command_arena;
+    u64 command_arena_live_count;
+    platform_mutex command_arena_mutex;
+    // Command scope allocations that did not fit in the arena
+    u64 command_arena_overflow_count;
+    // Bytes the driver reported allocating itself (pfnInternalAllocation)
+    u64 internal_allocated;
+} vulkan_host_allocator;
+
 typedef struct vulkan_context {
 
     // The frame buffer's current dimensions
@@ -172,7 +194,9 @@ typedef struct vulkan_context {
     u64 frame_buffer_size_last_generation;
 
     VkInstance instance;
+    // Points at host_allocator.callbacks, or 0 to use the driver's own allocator
     VkAllocationCallbacks* allocator;
+    vulkan_host_allocator host_allocator;
     VkSurfaceKHR surface;
 
 #if defined(_DEBUG)
@@ -212,6 +236,16 @@ typedef struct vulkan_context {
     b8 recreating_swapchain;
 
     vulkan_object_shader object_shader;
+    // Set when a stage binary of the object shader changed on disk
+    b8 object_shader_reload_pending;
+
+    // GPU frame timing, two timestamps per frame in flight. Null if the
+    // graphics queue does not support timestamps.
+    VkQueryPool timestamp_query_pool;
+    // Bit per frame in flight, set while that frame's timestamps are pending
+    u32 timestamps_pending_mask;
+    u64 gpu_timed_frame_count;
+    f64 gpu_time_total_ms;
 
     i32 (*find_memory_index)(u32 type_filter, u32 proprtty_flags);
 
@@ -13,6 +13,15 @@ b8 create_game(game* out_game){
     out_game->app_config.start_width = 1280;
     out_game->app_config.start_height = 720;
     out_game->app_config.name = "PE Sandbox test";
+#if PE_HEADLESS
+    // Headless runs are benchmarks; stop after a fixed number of frames
+    out_game->app_config.max_frame_count = 1000;
+    out_game->app_config.target_frame_rate = 0;
+#else
+    out_game->app_config.max_frame_count = 0;
+    out_game->app_config.target_frame_rate = 60;
+#endif
+    out_game->app_config.memory_budgets = 0;
 
     // Set game functions
     out_game->update = game_update;
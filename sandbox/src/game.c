@@ -13,10 +13,14 @@ b8 game_initialize(game* game_inst) {
 b8 game_update(game* game_inst, f32 delta_time) {
     
     static u64 alloc_count = 0;
+    static u64 free_count = 0;
     u64 prev_alloc_count = alloc_count;
+    u64 prev_free_count = free_count;
     alloc_count = get_memory_alloc_count();
+    free_count = get_memory_free_count();
     if (input_is_key_up('M') && input_was_key_down('M')) {
-        PE_DEBUG("Allocations: %llu (%llu this frame)", alloc_count, alloc_count - prev_alloc_count);
+        PE_DEBUG("Allocations: %llu live (%llu allocs, %llu frees this frame)",
+            alloc_count - free_count, alloc_count - prev_alloc_count, free_count - prev_free_count);
     }
 
     return true;
@@ -0,0 +1,129 @@
+#include "bitset_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/bitset.h>
+
+u8 bitset_set_test_and_count() {
+    bitset set;
+    expect_to_be_true(bitset_create(1000, &set));
+    expect_should_be(0, bitset_count(&set));
+    expect_to_be_false(bitset_any(&set));
+
+    bitset_set(&set, 0);
+    bitset_set(&set, 63);
+    bitset_set(&set, 64);
+    bitset_set(&set, 999);
+    bitset_assign(&set, 500, true);
+    expect_to_be_true(bitset_test(&set, 63));
+    expect_to_be_true(bitset_test(&set, 500));
+    expect_to_be_false(bitset_test(&set, 62));
+    expect_should_be(5, bitset_count(&set));
+
+    bitset_clear(&set, 63);
+    bitset_assign(&set, 500, false);
+    expect_should_be(3, bitset_count(&set));
+
+    // Bits past the end stay clear, so counts are exact
+    bitset_set_all(&set);
+    expect_should_be(1000, bitset_count(&set));
+    bitset_clear_all(&set);
+    expect_to_be_false(bitset_any(&set));
+
+    bitset_destroy(&set);
+    expect_should_be(0, set.words);
+    return true;
+}
+
+u8 bitset_find_next_iterates_set_bits() {
+    bitset set;
+    bitset_create(2000, &set);
+
+    // Spread out so whole empty blocks get skipped
+    u64 bits[6] = {3, 64, 65, 700, 1500, 1999};
+    for (u32 i = 0; i < 6; ++i) {
+        bitset_set(&set, bits[i]);
+    }
+
+    u32 found = 0;
+    for (u64 i = bitset_find_next(&set, 0); i < set.bit_count; i = bitset_find_next(&set, i + 1)) {
+        expect_should_be(bits[found], i);
+        found++;
+    }
+    expect_should_be(6, found);
+    expect_should_be(700, bitset_find_next(&set, 66));
+    expect_should_be(set.bit_count, bitset_find_next(&set, 2000));
+
+    bitset_destroy(&set);
+    return true;
+}
+
+u8 bitset_bulk_operations() {
+    bitset a;
+    bitset b;
+    bitset out;
+    bitset_create(300, &a);
+    bitset_create(300, &b);
+    bitset_create(300, &out);
+
+    // a holds multiples of 2, b multiples of 3
+    for (u64 i = 0; i < 300; ++i) {
+        if (i % 2 == 0) {
+            bitset_set(&a, i);
+        }
+        if (i % 3 == 0) {
+            bitset_set(&b, i);
+        }
+    }
+
+    bitset_and(&out, &a, &b);
+    expect_should_be(50, bitset_count(&out));
+    expect_to_be_true(bitset_test(&out, 6));
+    expect_to_be_false(bitset_test(&out, 4));
+
+    bitset_or(&out, &a, &b);
+    expect_should_be(200, bitset_count(&out));
+
+    bitset_andnot(&out, &a, &b);
+    expect_should_be(100, bitset_count(&out));
+    expect_to_be_true(bitset_test(&out, 4));
+    expect_to_be_false(bitset_test(&out, 6));
+
+    // In place
+    bitset_and(&a, &a, &b);
+    expect_should_be(50, bitset_count(&a));
+
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+    bitset_destroy(&out);
+    return true;
+}
+
+u8 bitset_resize_keeps_and_clears_bits() {
+    bitset set;
+    bitset_create(100, &set);
+    bitset_set_all(&set);
+
+    expect_to_be_true(bitset_resize(&set, 1000));
+    expect_should_be(100, bitset_count(&set));
+    expect_to_be_false(bitset_test(&set, 100));
+
+    expect_to_be_true(bitset_resize(&set, 10));
+    expect_should_be(10, bitset_count(&set));
+
+    // Growing again brings back cleared bits, not old ones
+    bitset_resize(&set, 100);
+    expect_should_be(10, bitset_count(&set));
+
+    bitset_destroy(&set);
+    return true;
+}
+
+void bitset_register_tests() {
+    test_manager_register_test(bitset_set_test_and_count, "Bitset set, test and count");
+    test_manager_register_test(bitset_find_next_iterates_set_bits, "Bitset find_next iterates set bits");
+    test_manager_register_test(bitset_bulk_operations, "Bitset bulk and/or/andnot");
+    test_manager_register_test(bitset_resize_keeps_and_clears_bits, "Bitset resize keeps and clears bits");
+}
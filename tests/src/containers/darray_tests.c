@@ -0,0 +1,220 @@
+#include "darray_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/darray.h>
+#include <core/pe_memory.h>
+
+u8 darray_should_create_and_grow() {
+    u32* array = darray_create(u32);
+    expect_should_not_be(0, array);
+    expect_should_be(0, darray_length(array));
+    expect_should_be(DARRAY_DEFAULT_CAPACITY, darray_capacity(array));
+    expect_should_be(sizeof(u32), darray_stride(array));
+
+    for (u32 i = 0; i < 100; ++i) {
+        darray_push(array, i);
+    }
+    expect_should_be(100, darray_length(array));
+    b8 has_room = darray_capacity(array) >= 100;
+    expect_to_be_true(has_room);
+    for (u32 i = 0; i < 100; ++i) {
+        expect_should_be(i, array[i]);
+    }
+
+    darray_destroy(array);
+    return true;
+}
+
+u8 darray_append_n_and_reserve_more() {
+    u32 values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    u32* array = darray_create(u32);
+    darray_push(array, 100);
+
+    darray_reserve_more(array, 10);
+    u64 capacity = darray_capacity(array);
+    b8 has_room = capacity >= 11;
+    expect_to_be_true(has_room);
+
+    // Already reserved, so appending doesn't grow again
+    darray_append_n(array, values, 10);
+    expect_should_be(capacity, darray_capacity(array));
+    expect_should_be(11, darray_length(array));
+    expect_should_be(100, array[0]);
+    for (u32 i = 0; i < 10; ++i) {
+        expect_should_be(i, array[i + 1]);
+    }
+
+    darray_shrink_to_fit(array);
+    expect_should_be(11, darray_capacity(array));
+    expect_should_be(9, array[10]);
+
+    darray_destroy(array);
+    return true;
+}
+
+u8 darray_insert_and_remove_keep_order() {
+    u32* array = darray_create(u32);
+    for (u32 i = 0; i < 5; ++i) {
+        darray_push(array, i * 10);
+    }
+
+    // Front, middle and end
+    darray_insert_at(array, 0, (u32)1);
+    darray_insert_at(array, 3, (u32)2);
+    darray_insert_at(array, darray_length(array), (u32)3);
+    u32 expected[8] = {1, 0, 10, 2, 20, 30, 40, 3};
+    expect_should_be(8, darray_length(array));
+    for (u32 i = 0; i < 8; ++i) {
+        expect_should_be(expected[i], array[i]);
+    }
+
+    u32 popped = 0;
+    darray_pop_at(array, 3, &popped);
+    expect_should_be(2, popped);
+    darray_remove_at(array, 0);
+    u32 remaining[6] = {0, 10, 20, 30, 40, 3};
+    expect_should_be(6, darray_length(array));
+    for (u32 i = 0; i < 6; ++i) {
+        expect_should_be(remaining[i], array[i]);
+    }
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    darray_remove_at(array, 6);
+    expect_should_be(6, darray_length(array));
+
+    darray_destroy(array);
+    return true;
+}
+
+u8 darray_swap_remove_fills_hole_with_last() {
+    u32* array = darray_create(u32);
+    for (u32 i = 0; i < 5; ++i) {
+        darray_push(array, i);
+    }
+
+    u32 removed = 0;
+    darray_swap_remove(array, 1, &removed);
+    expect_should_be(1, removed);
+    expect_should_be(4, darray_length(array));
+    expect_should_be(4, array[1]);
+
+    // Removing the last element needs no fill
+    darray_swap_remove(array, 3, 0);
+    expect_should_be(3, darray_length(array));
+    expect_should_be(0, array[0]);
+    expect_should_be(4, array[1]);
+    expect_should_be(2, array[2]);
+
+    darray_destroy(array);
+    return true;
+}
+
+u8 darray_failed_growth_leaves_array_intact() {
+    // Room for the header and 8 u32s, so growing past 8 elements is refused
+    memory_system_configuration config = {0};
+    config.budgets[MEMORY_TAG_DARRAY].hard_limit = DARRAY_FIELD_LENGTH * sizeof(u64) + 8 * sizeof(u32);
+    u64 memory_requirement = 0;
+    memory_system_initialize(&memory_requirement, 0, config);
+    void* memory_state = pe_allocate_aligned(memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(memory_system_initialize(&memory_requirement, memory_state, config));
+
+    u32* array = darray_create(u32);
+    for (u32 i = 0; i < 8; ++i) {
+        darray_push(array, i);
+    }
+    expect_should_be(8, darray_capacity(array));
+
+    u32* before = array;
+    u32 values[4] = {100, 101, 102, 103};
+    PE_DEBUG("Note: The following errors are intentionally caused by this test.");
+    darray_push(array, 8);
+    darray_append_n(array, values, 4);
+    darray_insert_at(array, 0, 200);
+    darray_reserve_more(array, 1);
+
+    // Nothing was added, and nothing was written past the end
+    expect_should_be(before, array);
+    expect_should_be(8, darray_length(array));
+    expect_should_be(8, darray_capacity(array));
+    for (u32 i = 0; i < 8; ++i) {
+        expect_should_be(i, array[i]);
+    }
+
+    darray_destroy(array);
+    memory_tag_stats stats;
+    memory_get_tag_stats(MEMORY_TAG_DARRAY, &stats);
+    expect_should_be(0, stats.allocated_bytes);
+
+    // Creating an array over the budget fails instead of writing through null
+    PE_DEBUG("Note: The following errors are intentionally caused by this test.");
+    expect_should_be(0, darray_reserve(u32, 9));
+
+    memory_system_shutdown(memory_state);
+    pe_free_aligned(memory_state, memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 darray_push_and_pop_inline() {
+    u64* array = darray_reserve(u64, 4);
+    // Named like the macro internals used to be, to check they don't shadow the caller's
+    u64 darray_header = 11;
+    u64 temp = 12;
+    darray_push(array, darray_header);
+    darray_push(array, temp);
+    darray_push(array, (u64)13);
+    expect_should_be(3, darray_length(array));
+    expect_should_be(11, array[0]);
+    expect_should_be(12, array[1]);
+    expect_should_be(13, array[2]);
+
+    // Literals and const values are converted to the element type, negative ones included
+    const u64 constant = 14;
+    darray_push(array, constant);
+    darray_push(array, -1);
+    expect_should_be(5, darray_length(array));
+    expect_should_be(14, array[3]);
+    expect_should_be(0xFFFFFFFFFFFFFFFF, array[4]);
+
+    u64 value = 0;
+    darray_pop(array, &value);
+    expect_should_be(0xFFFFFFFFFFFFFFFF, value);
+    darray_pop(array, &value);
+    expect_should_be(14, value);
+    darray_pop(array, &value);
+    expect_should_be(13, value);
+    darray_pop(array, &value);
+    expect_should_be(12, value);
+    darray_pop(array, &value);
+    expect_should_be(11, value);
+    expect_should_be(0, darray_length(array));
+
+    // Popping an empty array leaves the destination and the length alone
+    value = 99;
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    darray_pop(array, &value);
+    expect_should_be(99, value);
+    expect_should_be(0, darray_length(array));
+    darray_destroy(array);
+
+    // Goes through the inline path, then through growth when full
+    u32* small = darray_reserve(u32, 1);
+    darray_push(small, 7);
+    darray_push(small, 8ull);
+    expect_should_be(2, darray_length(small));
+    expect_should_be(7, small[0]);
+    expect_should_be(8, small[1]);
+    darray_destroy(small);
+    return true;
+}
+
+void darray_register_tests() {
+    test_manager_register_test(darray_should_create_and_grow, "Darray should create and grow");
+    test_manager_register_test(darray_append_n_and_reserve_more, "Darray append_n and reserve_more");
+    test_manager_register_test(darray_insert_and_remove_keep_order, "Darray insert and remove keep order");
+    test_manager_register_test(darray_swap_remove_fills_hole_with_last, "Darray swap remove");
+    test_manager_register_test(darray_failed_growth_leaves_array_intact, "Darray failed growth leaves array intact");
+    test_manager_register_test(darray_push_and_pop_inline, "Darray push and pop inline");
+}
@@ -0,0 +1,147 @@
+#include "hashtable_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/hashtable.h>
+#include <core/pe_string.h>
+
+u8 hashtable_should_create_and_destroy() {
+    hashtable table;
+    expect_to_be_true(hashtable_create(sizeof(u64), 100, &table));
+    expect_should_not_be(0, table.control);
+    expect_should_be(0, table.count);
+    b8 has_room = table.growth_limit >= 100;
+    expect_to_be_true(has_room);
+
+    hashtable_destroy(&table);
+    expect_should_be(0, table.control);
+    expect_should_be(0, table.capacity);
+
+    return true;
+}
+
+u8 hashtable_set_get_and_overwrite() {
+    hashtable table;
+    hashtable_create(sizeof(u64), 0, &table);
+
+    u64 value = 23;
+    expect_to_be_true(hashtable_set(&table, "alpha", &value));
+    value = 42;
+    expect_to_be_true(hashtable_set(&table, "beta", &value));
+    expect_should_be(2, table.count);
+
+    u64* alpha = hashtable_get(&table, "alpha");
+    expect_should_not_be(0, alpha);
+    expect_should_be(23, *alpha);
+    expect_should_be(42, *(u64*)hashtable_get(&table, "beta"));
+    expect_should_be(0, hashtable_get(&table, "gamma"));
+    expect_to_be_false(hashtable_contains(&table, "gamma"));
+
+    // Overwriting keeps the count
+    value = 7;
+    hashtable_set(&table, "alpha", &value);
+    expect_should_be(2, table.count);
+    expect_should_be(7, *(u64*)hashtable_get(&table, "alpha"));
+
+    hashtable_destroy(&table);
+    return true;
+}
+
+u8 hashtable_grows_and_keeps_entries() {
+    hashtable table;
+    hashtable_create(sizeof(u32), 0, &table);
+    u64 initial_capacity = table.capacity;
+
+    char key[32];
+    for (u32 i = 0; i < 1000; ++i) {
+        string_format(key, "entry_%u", i);
+        hashtable_set(&table, key, &i);
+    }
+    expect_should_be(1000, table.count);
+    b8 grew = table.capacity > initial_capacity;
+    expect_to_be_true(grew);
+
+    for (u32 i = 0; i < 1000; ++i) {
+        string_format(key, "entry_%u", i);
+        u32* value = hashtable_get(&table, key);
+        expect_should_not_be(0, value);
+        expect_should_be(i, *value);
+    }
+
+    hashtable_destroy(&table);
+    return true;
+}
+
+u8 hashtable_remove_keeps_other_entries_reachable() {
+    hashtable table;
+    hashtable_create(sizeof(u32), 0, &table);
+
+    // Fill close to the growth limit so probe runs are long and removal has to shift entries back
+    char key[32];
+    u32 count = (u32)table.growth_limit;
+    for (u32 i = 0; i < count; ++i) {
+        string_format(key, "entry_%u", i);
+        hashtable_set(&table, key, &i);
+    }
+    u64 capacity = table.capacity;
+
+    for (u32 i = 0; i < count; i += 2) {
+        string_format(key, "entry_%u", i);
+        expect_to_be_true(hashtable_remove(&table, key));
+    }
+    expect_should_be(count / 2, table.count);
+    expect_to_be_false(hashtable_remove(&table, "entry_0"));
+
+    for (u32 i = 0; i < count; ++i) {
+        string_format(key, "entry_%u", i);
+        u32* value = hashtable_get(&table, key);
+        if (i % 2 == 0) {
+            expect_should_be(0, value);
+        } else {
+            expect_should_not_be(0, value);
+            expect_should_be(i, *value);
+        }
+    }
+
+    // Removed slots are free again, so refilling doesn't grow
+    for (u32 i = 0; i < count; i += 2) {
+        string_format(key, "entry_%u", i);
+        hashtable_set(&table, key, &i);
+    }
+    expect_should_be(capacity, table.capacity);
+
+    hashtable_clear(&table);
+    expect_should_be(0, table.count);
+    expect_to_be_false(hashtable_contains(&table, "entry_1"));
+
+    hashtable_destroy(&table);
+    return true;
+}
+
+u8 hashtable_reserve_avoids_growth() {
+    hashtable table;
+    hashtable_create(0, 0, &table);
+    expect_to_be_true(hashtable_reserve(&table, 500));
+    u64 capacity = table.capacity;
+
+    char key[32];
+    for (u32 i = 0; i < 500; ++i) {
+        string_format(key, "key_%u", i);
+        hashtable_set(&table, key, 0);
+    }
+    expect_should_be(capacity, table.capacity);
+    expect_to_be_true(hashtable_contains(&table, "key_499"));
+
+    hashtable_destroy(&table);
+    return true;
+}
+
+void hashtable_register_tests() {
+    test_manager_register_test(hashtable_should_create_and_destroy, "Hashtable should create and destroy");
+    test_manager_register_test(hashtable_set_get_and_overwrite, "Hashtable set, get and overwrite");
+    test_manager_register_test(hashtable_grows_and_keeps_entries, "Hashtable grows and keeps entries");
+    test_manager_register_test(hashtable_remove_keeps_other_entries_reachable, "Hashtable remove keeps other entries reachable");
+    test_manager_register_test(hashtable_reserve_avoids_growth, "Hashtable reserve avoids growth");
+}
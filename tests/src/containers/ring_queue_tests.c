@@ -0,0 +1,163 @@
+#include "ring_queue_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/ring_queue.h>
+#include <platform/platform.h>
+
+#define THREADED_ITEM_COUNT 200000
+#define MPMC_THREAD_COUNT 4
+
+u8 ring_queue_push_pop_in_order_and_wrap() {
+    ring_queue queue;
+    expect_to_be_true(ring_queue_create(sizeof(u32), 5, &queue));
+    // Rounded up to a power of two
+    expect_should_be(8, queue.capacity);
+
+    // Run a few laps so indices wrap around the buffer
+    u32 next_push = 0;
+    u32 next_pop = 0;
+    for (u32 lap = 0; lap < 4; ++lap) {
+        while (ring_queue_push(&queue, &next_push)) {
+            next_push++;
+        }
+        expect_should_be(8, ring_queue_length(&queue));
+
+        u32 front = 0;
+        expect_to_be_true(ring_queue_peek(&queue, &front));
+        expect_should_be(next_pop, front);
+
+        for (u32 i = 0; i < 5; ++i) {
+            u32 value = 0;
+            expect_to_be_true(ring_queue_pop(&queue, &value));
+            expect_should_be(next_pop, value);
+            next_pop++;
+        }
+    }
+
+    u32 value = 0;
+    while (ring_queue_pop(&queue, &value)) {
+        expect_should_be(next_pop, value);
+        next_pop++;
+    }
+    expect_should_be(next_push, next_pop);
+    expect_to_be_false(ring_queue_peek(&queue, &value));
+
+    ring_queue_destroy(&queue);
+    expect_should_be(0, queue.buffer);
+    return true;
+}
+
+u8 ring_queue_indices_on_separate_cache_lines() {
+    ring_queue_spsc spsc;
+    ring_queue_mpmc mpmc;
+    u64 spsc_distance = (u64)((u8*)&spsc.head - (u8*)&spsc.tail);
+    u64 mpmc_distance = (u64)((u8*)&mpmc.dequeue_position - (u8*)&mpmc.enqueue_position);
+    expect_should_be(0, (u64)&spsc.tail % PE_CACHE_LINE_SIZE);
+    expect_should_be(0, (u64)&spsc.head % PE_CACHE_LINE_SIZE);
+    expect_should_be(PE_CACHE_LINE_SIZE, spsc_distance);
+    expect_should_be(PE_CACHE_LINE_SIZE, mpmc_distance);
+    return true;
+}
+
+static u32 spsc_producer(void* params) {
+    ring_queue_spsc* queue = params;
+    for (u64 i = 0; i < THREADED_ITEM_COUNT; ++i) {
+        while (!ring_queue_spsc_push(queue, &i)) {
+            platform_thread_yield();
+        }
+    }
+    return 0;
+}
+
+u8 ring_queue_spsc_across_threads() {
+    ring_queue_spsc queue;
+    expect_to_be_true(ring_queue_spsc_create(sizeof(u64), 256, &queue));
+
+    platform_thread producer;
+    expect_to_be_true(platform_thread_create(spsc_producer, &queue, false, &producer));
+
+    // Everything arrives, in order. Keeps draining after a mismatch so the producer can finish and be joined.
+    b8 in_order = true;
+    for (u64 expected = 0; expected < THREADED_ITEM_COUNT; ++expected) {
+        u64 value;
+        while (!ring_queue_spsc_pop(&queue, &value)) {
+            platform_thread_yield();
+        }
+        if (value != expected) {
+            in_order = false;
+        }
+    }
+    platform_thread_join(&producer);
+    expect_to_be_true(in_order);
+    expect_should_be(0, ring_queue_spsc_length(&queue));
+
+    ring_queue_spsc_destroy(&queue);
+    return true;
+}
+
+typedef struct mpmc_test_context {
+    ring_queue_mpmc queue;
+    u64 popped_count;
+    u64 popped_sum;
+} mpmc_test_context;
+
+static u32 mpmc_producer(void* params) {
+    mpmc_test_context* context = params;
+    for (u64 i = 1; i <= THREADED_ITEM_COUNT; ++i) {
+        while (!ring_queue_mpmc_push(&context->queue, &i)) {
+            platform_thread_yield();
+        }
+    }
+    return 0;
+}
+
+static u32 mpmc_consumer(void* params) {
+    mpmc_test_context* context = params;
+    u64 sum = 0;
+    while (PE_ATOMIC_LOAD(&context->popped_count, PE_ATOMIC_RELAXED) < (u64)THREADED_ITEM_COUNT * MPMC_THREAD_COUNT) {
+        u64 value;
+        if (ring_queue_mpmc_pop(&context->queue, &value)) {
+            sum += value;
+            PE_ATOMIC_FETCH_ADD(&context->popped_count, 1, PE_ATOMIC_RELAXED);
+        } else {
+            platform_thread_yield();
+        }
+    }
+    PE_ATOMIC_FETCH_ADD(&context->popped_sum, sum, PE_ATOMIC_RELAXED);
+    return 0;
+}
+
+u8 ring_queue_mpmc_across_threads() {
+    mpmc_test_context context = {0};
+    expect_to_be_true(ring_queue_mpmc_create(sizeof(u64), 1024, &context.queue));
+
+    platform_thread producers[MPMC_THREAD_COUNT];
+    platform_thread consumers[MPMC_THREAD_COUNT];
+    for (u32 i = 0; i < MPMC_THREAD_COUNT; ++i) {
+        expect_to_be_true(platform_thread_create(mpmc_producer, &context, false, &producers[i]));
+        expect_to_be_true(platform_thread_create(mpmc_consumer, &context, false, &consumers[i]));
+    }
+    for (u32 i = 0; i < MPMC_THREAD_COUNT; ++i) {
+        platform_thread_join(&producers[i]);
+        platform_thread_join(&consumers[i]);
+    }
+
+    // Each element popped exactly once
+    u64 expected_sum = (u64)MPMC_THREAD_COUNT * THREADED_ITEM_COUNT * (THREADED_ITEM_COUNT + 1) / 2;
+    expect_should_be((u64)THREADED_ITEM_COUNT * MPMC_THREAD_COUNT, context.popped_count);
+    expect_should_be(expected_sum, context.popped_sum);
+    expect_should_be(0, ring_queue_mpmc_length(&context.queue));
+
+    ring_queue_mpmc_destroy(&context.queue);
+    return true;
+}
+
+void ring_queue_register_tests() {
+    test_manager_register_test(ring_queue_push_pop_in_order_and_wrap, "Ring queue push/pop in order and wrap");
+    test_manager_register_test(ring_queue_indices_on_separate_cache_lines, "Ring queue indices on separate cache lines");
+    test_manager_register_test(ring_queue_spsc_across_threads, "Ring queue SPSC across threads");
+    test_manager_register_test(ring_queue_mpmc_across_threads, "Ring queue MPMC across threads");
+}
@@ -0,0 +1,166 @@
+#include "slot_map_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/slot_map.h>
+#include <core/pe_memory.h>
+
+typedef struct test_object {
+    u64 id;
+    f32 position[3];
+} test_object;
+
+u8 slot_map_should_create_and_destroy() {
+    slot_map map;
+    expect_to_be_true(slot_map_create(sizeof(test_object), 32, &map));
+    expect_should_not_be(0, map.values);
+    expect_should_be(0, map.count);
+    expect_should_be(32, map.capacity);
+
+    slot_map_destroy(&map);
+    expect_should_be(0, map.values);
+    expect_should_be(0, map.capacity);
+    return true;
+}
+
+u8 slot_map_insert_get_and_remove() {
+    slot_map map;
+    slot_map_create(sizeof(test_object), 0, &map);
+
+    test_object a = {1, {1.0f, 2.0f, 3.0f}};
+    test_object b = {2, {4.0f, 5.0f, 6.0f}};
+    slot_map_handle handle_a = slot_map_insert(&map, &a);
+    slot_map_handle handle_b = slot_map_insert(&map, &b);
+    expect_should_not_be(0, handle_a.generation);
+    expect_to_be_false(slot_map_handles_equal(handle_a, handle_b));
+    expect_should_be(2, map.count);
+
+    test_object* found = slot_map_get(&map, handle_a);
+    expect_should_not_be(0, found);
+    expect_should_be(1, found->id);
+    expect_should_be(2, ((test_object*)slot_map_get(&map, handle_b))->id);
+
+    expect_to_be_true(slot_map_remove(&map, handle_a));
+    expect_should_be(1, map.count);
+    expect_should_be(0, slot_map_get(&map, handle_a));
+    expect_to_be_false(slot_map_remove(&map, handle_a));
+
+    // The moved value is still reachable through its handle
+    expect_should_be(2, ((test_object*)slot_map_get(&map, handle_b))->id);
+
+    expect_to_be_false(slot_map_contains(&map, SLOT_MAP_INVALID_HANDLE));
+
+    slot_map_destroy(&map);
+    return true;
+}
+
+u8 slot_map_reused_slot_stales_old_handle() {
+    slot_map map;
+    slot_map_create(sizeof(u64), 0, &map);
+
+    u64 value = 10;
+    slot_map_handle old_handle = slot_map_insert(&map, &value);
+    slot_map_remove(&map, old_handle);
+
+    value = 20;
+    slot_map_handle new_handle = slot_map_insert(&map, &value);
+    // Same slot, new generation
+    expect_should_be(old_handle.index, new_handle.index);
+    expect_should_not_be(old_handle.generation, new_handle.generation);
+    expect_should_be(0, slot_map_get(&map, old_handle));
+    expect_should_be(20, *(u64*)slot_map_get(&map, new_handle));
+
+    slot_map_clear(&map);
+    expect_should_be(0, map.count);
+    expect_should_be(0, slot_map_get(&map, new_handle));
+
+    slot_map_destroy(&map);
+    return true;
+}
+
+u8 slot_map_values_stay_dense_and_handles_survive_growth() {
+    slot_map map;
+    slot_map_create(sizeof(u64), 0, &map);
+    u32 initial_capacity = map.capacity;
+
+    slot_map_handle handles[100];
+    for (u64 i = 0; i < 100; ++i) {
+        handles[i] = slot_map_insert(&map, &i);
+    }
+    b8 grew = map.capacity > initial_capacity;
+    expect_to_be_true(grew);
+
+    // Remove every third value
+    for (u32 i = 0; i < 100; i += 3) {
+        expect_to_be_true(slot_map_remove(&map, handles[i]));
+    }
+    expect_should_be(66, map.count);
+
+    // Iterating the dense array visits exactly the live values
+    u64* values = (u64*)map.values;
+    u64 sum = 0;
+    for (u32 i = 0; i < map.count; ++i) {
+        sum += values[i];
+        slot_map_handle handle = slot_map_handle_at(&map, i);
+        expect_should_be(values[i], *(u64*)slot_map_get(&map, handle));
+    }
+    u64 expected_sum = 0;
+    for (u64 i = 0; i < 100; ++i) {
+        if (i % 3 != 0) {
+            expected_sum += i;
+            expect_should_be(i, *(u64*)slot_map_get(&map, handles[i]));
+        }
+    }
+    expect_should_be(expected_sum, sum);
+
+    slot_map_destroy(&map);
+    return true;
+}
+
+u8 slot_map_failed_growth_keeps_capacity() {
+    // Room for the slots and dense_to_slot at 32 elements, but not the values as well
+    memory_system_configuration config = {0};
+    config.budgets[MEMORY_TAG_SLOT_MAP].hard_limit = 16 * (sizeof(slot_map_slot) + sizeof(u32) + sizeof(test_object)) +
+                                                     32 * (sizeof(slot_map_slot) + sizeof(u32));
+    u64 memory_requirement = 0;
+    memory_system_initialize(&memory_requirement, 0, config);
+    void* memory_state = pe_allocate_aligned(memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(memory_system_initialize(&memory_requirement, memory_state, config));
+
+    slot_map map;
+    expect_to_be_true(slot_map_create(sizeof(test_object), 16, &map));
+    memory_tag_stats before;
+    memory_get_tag_stats(MEMORY_TAG_SLOT_MAP, &before);
+
+    PE_DEBUG("Note: The following errors are intentionally caused by this test.");
+    expect_to_be_false(slot_map_reserve(&map, 32));
+    expect_should_be(16, map.capacity);
+
+    // The arrays that grew were shrunk back, so nothing is left over once destroyed
+    memory_tag_stats after;
+    memory_get_tag_stats(MEMORY_TAG_SLOT_MAP, &after);
+    expect_should_be(before.allocated_bytes, after.allocated_bytes);
+    slot_map_destroy(&map);
+    memory_get_tag_stats(MEMORY_TAG_SLOT_MAP, &after);
+    expect_should_be(0, after.allocated_bytes);
+
+    // Same when creation itself fails part way
+    PE_DEBUG("Note: The following errors are intentionally caused by this test.");
+    expect_to_be_false(slot_map_create(sizeof(test_object), 64, &map));
+    memory_get_tag_stats(MEMORY_TAG_SLOT_MAP, &after);
+    expect_should_be(0, after.allocated_bytes);
+
+    memory_system_shutdown(memory_state);
+    pe_free_aligned(memory_state, memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+void slot_map_register_tests() {
+    test_manager_register_test(slot_map_should_create_and_destroy, "Slot map should create and destroy");
+    test_manager_register_test(slot_map_insert_get_and_remove, "Slot map insert, get and remove");
+    test_manager_register_test(slot_map_reused_slot_stales_old_handle, "Slot map reused slot stales old handle");
+    test_manager_register_test(slot_map_values_stay_dense_and_handles_survive_growth, "Slot map values stay dense and handles survive growth");
+    test_manager_register_test(slot_map_failed_growth_keeps_capacity, "Slot map failed growth keeps capacity");
+}
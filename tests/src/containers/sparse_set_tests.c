@@ -0,0 +1,74 @@
+#include "sparse_set_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <containers/sparse_set.h>
+
+u8 sparse_set_insert_remove_and_contains() {
+    sparse_set set;
+    expect_to_be_true(sparse_set_create(100, 0, &set));
+
+    expect_to_be_true(sparse_set_insert(&set, 5));
+    expect_to_be_true(sparse_set_insert(&set, 42));
+    expect_to_be_true(sparse_set_insert(&set, 7));
+    expect_to_be_false(sparse_set_insert(&set, 42));
+    expect_should_be(3, set.count);
+    expect_to_be_true(sparse_set_contains(&set, 42));
+    expect_to_be_false(sparse_set_contains(&set, 6));
+
+    // The last member fills the hole
+    expect_to_be_true(sparse_set_remove(&set, 5));
+    expect_to_be_false(sparse_set_remove(&set, 5));
+    expect_should_be(2, set.count);
+    expect_should_be(7, set.dense[0]);
+    expect_should_be(42, set.dense[1]);
+    expect_to_be_true(sparse_set_contains(&set, 7));
+
+    sparse_set_clear(&set);
+    expect_should_be(0, set.count);
+    expect_to_be_false(sparse_set_contains(&set, 42));
+
+    sparse_set_destroy(&set);
+    expect_should_be(0, set.dense);
+    return true;
+}
+
+u8 sparse_set_grows_for_large_ids_and_many_members() {
+    sparse_set set;
+    sparse_set_create(0, 0, &set);
+
+    for (u32 i = 0; i < 1000; ++i) {
+        expect_to_be_true(sparse_set_insert(&set, i * 37));
+    }
+    expect_should_be(1000, set.count);
+    for (u32 i = 0; i < 1000; ++i) {
+        expect_to_be_true(sparse_set_contains(&set, i * 37));
+        expect_to_be_false(sparse_set_contains(&set, i * 37 + 1));
+    }
+
+    sparse_set_destroy(&set);
+    return true;
+}
+
+u8 sparse_set_rejects_ids_at_the_limit() {
+    sparse_set set;
+    PE_DEBUG("Note: The following errors are intentionally caused by this test.");
+    expect_to_be_false(sparse_set_create(SPARSE_SET_ID_LIMIT, 0, &set));
+
+    expect_to_be_true(sparse_set_create(100, 0, &set));
+    expect_to_be_false(sparse_set_insert(&set, SPARSE_SET_ID_LIMIT));
+    expect_should_be(0, set.count);
+    expect_should_be(100 + 1, set.sparse_capacity);
+    expect_to_be_false(sparse_set_contains(&set, SPARSE_SET_ID_LIMIT));
+
+    sparse_set_destroy(&set);
+    return true;
+}
+
+void sparse_set_register_tests() {
+    test_manager_register_test(sparse_set_insert_remove_and_contains, "Sparse set insert, remove and contains");
+    test_manager_register_test(sparse_set_grows_for_large_ids_and_many_members, "Sparse set grows for large ids");
+    test_manager_register_test(sparse_set_rejects_ids_at_the_limit, "Sparse set rejects ids at the limit");
+}
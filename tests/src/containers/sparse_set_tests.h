@@ -0,0 +1,3 @@
+#pragma once
+
+void sparse_set_register_tests();
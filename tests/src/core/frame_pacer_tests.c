@@ -0,0 +1,116 @@
+#include "frame_pacer_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/frame_pacer.h>
+#include <core/clock.h>
+
+// Stands in for a frame's work
+static void busy_wait(f64 seconds) {
+    clock timer;
+    clock_start(&timer);
+    do {
+        clock_update(&timer);
+    } while (timer.elapsed < seconds);
+}
+
+u8 frame_pacer_unlimited_does_not_wait() {
+    frame_pacer pacer;
+    frame_pacer_create(0, &pacer);
+
+    expect_should_be(0, pacer.next_deadline);
+    b8 no_error = frame_pacer_wait(&pacer) == 0;
+    expect_to_be_true(no_error);
+    expect_should_be(0, pacer.next_deadline);
+    expect_should_be(1, pacer.stats.frame_count);
+
+    return true;
+}
+
+u8 frame_pacer_schedules_from_previous_deadline() {
+    frame_pacer pacer;
+    frame_pacer_create(100.0, &pacer);
+    b8 calibrated = pacer.overshoot_estimate >= 0;
+    expect_to_be_true(calibrated);
+
+    // The first frame only starts the schedule
+    clock timer;
+    clock_start(&timer);
+    frame_pacer_wait(&pacer);
+    f64 first_deadline = pacer.next_deadline;
+    b8 deadline_set = first_deadline > 0;
+    expect_to_be_true(deadline_set);
+
+    f64 error = frame_pacer_wait(&pacer);
+    clock_update(&timer);
+    // Waited out the frame, and never wakes early
+    b8 waited = timer.elapsed >= pacer.target_frame_seconds * 0.9;
+    expect_to_be_true(waited);
+    b8 not_early = error >= 0;
+    expect_to_be_true(not_early);
+
+    // Unless the frame was missed, the next deadline is a whole frame after the last one,
+    // not after when the wait happened to end
+    if (pacer.stats.missed_frame_count == 0) {
+        b8 no_drift = pacer.next_deadline == first_deadline + pacer.target_frame_seconds;
+        expect_to_be_true(no_drift);
+    }
+
+    return true;
+}
+
+u8 frame_pacer_spins_when_sleep_would_overshoot() {
+    frame_pacer pacer;
+    frame_pacer_create(100.0, &pacer);
+    frame_pacer_wait(&pacer);
+
+    // With an overshoot estimate past the whole frame, sleeping is never safe, so the
+    // wait spins and takes no new overshoot samples
+    pacer.overshoot_estimate = 1.0;
+    f64 mean = pacer.overshoot_mean;
+    f64 variance = pacer.overshoot_variance;
+    frame_pacer_wait(&pacer);
+    b8 spun = pacer.overshoot_mean == mean && pacer.overshoot_variance == variance;
+    expect_to_be_true(spun);
+
+    // With no overshoot expected, most of a 10ms frame is slept, and each sleep is measured
+    pacer.overshoot_mean = 0;
+    pacer.overshoot_variance = 0;
+    pacer.overshoot_estimate = 0;
+    frame_pacer_wait(&pacer);
+    b8 slept = pacer.overshoot_mean != 0 || pacer.overshoot_variance != 0;
+    expect_to_be_true(slept);
+
+    return true;
+}
+
+u8 frame_pacer_restarts_after_missed_frame() {
+    frame_pacer pacer;
+    frame_pacer_create(1000.0, &pacer);
+    frame_pacer_wait(&pacer);
+    f64 first_deadline = pacer.next_deadline;
+
+    // Several frames' worth of work; catching up would mean a burst of short frames
+    busy_wait(0.005);
+    f64 error = frame_pacer_wait(&pacer);
+    b8 late = error >= pacer.target_frame_seconds;
+    expect_to_be_true(late);
+    expect_should_be(1, pacer.stats.missed_frame_count);
+    b8 max_tracked = pacer.stats.max_error == error;
+    expect_to_be_true(max_tracked);
+
+    // Rescheduled from when the wait ended, not from the missed deadline
+    b8 restarted = pacer.next_deadline >= first_deadline + 0.005;
+    expect_to_be_true(restarted);
+
+    return true;
+}
+
+void frame_pacer_register_tests() {
+    test_manager_register_test(frame_pacer_unlimited_does_not_wait, "Frame pacer unlimited does not wait");
+    test_manager_register_test(frame_pacer_schedules_from_previous_deadline, "Frame pacer schedules from previous deadline");
+    test_manager_register_test(frame_pacer_spins_when_sleep_would_overshoot, "Frame pacer spins when sleep would overshoot");
+    test_manager_register_test(frame_pacer_restarts_after_missed_frame, "Frame pacer restarts after missed frame");
+}
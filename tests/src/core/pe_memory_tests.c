@@ -0,0 +1,253 @@
+#include "pe_memory_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/pe_memory.h>
+#include <core/event.h>
+#include <platform/platform.h>
+
+#define THREAD_COUNT 4
+#define THREAD_ALLOCATION_COUNT 100
+#define THREAD_ALLOCATION_SIZE 64
+
+typedef struct memory_test_system {
+    u64 memory_requirement;
+    void* state;
+} memory_test_system;
+
+static b8 test_system_start(memory_test_system* system, memory_system_configuration config) {
+    memory_system_initialize(&system->memory_requirement, 0, config);
+    system->state = pe_allocate_aligned(system->memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    return memory_system_initialize(&system->memory_requirement, system->state, config);
+}
+
+static void test_system_stop(memory_test_system* system) {
+    memory_system_shutdown(system->state);
+    pe_free_aligned(system->state, system->memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+}
+
+static b8 tag_stats_are(memory_tag tag, u64 allocated, u64 peak, u64 allocation_count, u64 free_count) {
+    memory_tag_stats stats;
+    memory_get_tag_stats(tag, &stats);
+    return stats.allocated_bytes == allocated && stats.peak_bytes == peak &&
+           stats.allocation_count == allocation_count && stats.free_count == free_count;
+}
+
+static u8 counts_allocations_frees_and_peak(memory_system_configuration config) {
+    memory_test_system system;
+    expect_to_be_true(test_system_start(&system, config));
+
+    void* a = pe_allocate(100, MEMORY_TAG_GAME);
+    void* b = pe_allocate_uninit(300, MEMORY_TAG_GAME);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 400, 400, 2, 0));
+
+    pe_free(b, 300, MEMORY_TAG_GAME);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 100, 400, 2, 1));
+
+    // Resizing changes the bytes, but is neither an allocation nor a free
+    a = pe_reallocate(a, 100, 600, MEMORY_TAG_GAME);
+    expect_should_not_be(0, a);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 600, 600, 2, 1));
+    a = pe_reallocate(a, 600, 50, MEMORY_TAG_GAME);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 50, 600, 2, 1));
+
+    pe_free(a, 50, MEMORY_TAG_GAME);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 0, 600, 2, 2));
+
+    // Other tags are untouched
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_TEXTURE, 0, 0, 0, 0));
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 pe_memory_counts_runtime_heap_allocations() {
+    memory_system_configuration config = {0};
+    return counts_allocations_frees_and_peak(config);
+}
+
+u8 pe_memory_counts_engine_heap_allocations() {
+    memory_system_configuration config = {0};
+    config.heap_size = 1024 * 1024;
+    config.heap_tag_mask = MEMORY_TAG_BIT(MEMORY_TAG_GAME);
+    return counts_allocations_frees_and_peak(config);
+}
+
+u8 pe_memory_commit_counts_bytes_only() {
+    memory_system_configuration config = {0};
+    memory_test_system system;
+    test_system_start(&system, config);
+
+    u64 page_size = pe_memory_page_size();
+    void* range = pe_memory_reserve(page_size * 4, false);
+    expect_should_not_be(0, range);
+
+    // Growing a reservation is not a new allocation
+    expect_to_be_true(pe_memory_commit(range, page_size * 2, false, MEMORY_TAG_LINEAR_ALLOCATOR));
+    expect_to_be_true(pe_memory_commit((u8*)range + page_size * 2, page_size, false, MEMORY_TAG_LINEAR_ALLOCATOR));
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_LINEAR_ALLOCATOR, page_size * 3, page_size * 3, 0, 0));
+
+    pe_memory_decommit(range, page_size * 3, MEMORY_TAG_LINEAR_ALLOCATOR);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_LINEAR_ALLOCATOR, 0, page_size * 3, 0, 0));
+    pe_memory_release(range, page_size * 4);
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 pe_memory_rejects_unaligned_state() {
+    memory_system_configuration config = {0};
+    u64 memory_requirement = 0;
+    memory_system_initialize(&memory_requirement, 0, config);
+    u8* block = pe_allocate_aligned(memory_requirement + 16, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_to_be_false(memory_system_initialize(&memory_requirement, block + 16, config));
+
+    pe_free_aligned(block, memory_requirement + 16, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 pe_memory_refuses_allocations_past_hard_limit() {
+    memory_system_configuration config = {0};
+    config.budgets[MEMORY_TAG_GAME].hard_limit = 1000;
+    memory_test_system system;
+    test_system_start(&system, config);
+
+    void* a = pe_allocate(600, MEMORY_TAG_GAME);
+    expect_should_not_be(0, a);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, pe_allocate(500, MEMORY_TAG_GAME));
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, pe_reallocate(a, 600, 1001, MEMORY_TAG_GAME));
+    // Refusals account nothing
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 600, 600, 1, 0));
+
+    // Right up to the limit is fine
+    void* b = pe_allocate(400, MEMORY_TAG_GAME);
+    expect_should_not_be(0, b);
+    expect_to_be_true(tag_stats_are(MEMORY_TAG_GAME, 1000, 1000, 2, 0));
+
+    pe_free(a, 600, MEMORY_TAG_GAME);
+    pe_free(b, 400, MEMORY_TAG_GAME);
+
+    test_system_stop(&system);
+    return true;
+}
+
+static u32 allocate_worker(void* params) {
+    void** blocks = params;
+    for (u32 i = 0; i < THREAD_ALLOCATION_COUNT; ++i) {
+        blocks[i] = pe_allocate_uninit(THREAD_ALLOCATION_SIZE, MEMORY_TAG_JOB);
+    }
+    return 0;
+}
+
+u8 pe_memory_hard_limit_exact_across_threads() {
+    // Exactly enough for every thread's allocations, so none may be refused
+    memory_system_configuration config = {0};
+    config.budgets[MEMORY_TAG_JOB].hard_limit = THREAD_COUNT * THREAD_ALLOCATION_COUNT * THREAD_ALLOCATION_SIZE;
+    memory_test_system system;
+    test_system_start(&system, config);
+
+    void* blocks[THREAD_COUNT][THREAD_ALLOCATION_COUNT];
+    platform_thread threads[THREAD_COUNT];
+    for (u32 i = 0; i < THREAD_COUNT; ++i) {
+        expect_to_be_true(platform_thread_create(allocate_worker, blocks[i], false, &threads[i]));
+    }
+    u32 refused = 0;
+    for (u32 i = 0; i < THREAD_COUNT; ++i) {
+        platform_thread_join(&threads[i]);
+        for (u32 j = 0; j < THREAD_ALLOCATION_COUNT; ++j) {
+            refused += blocks[i][j] == 0;
+        }
+    }
+    expect_should_be(0, refused);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, pe_allocate(1, MEMORY_TAG_JOB));
+
+    for (u32 i = 0; i < THREAD_COUNT; ++i) {
+        for (u32 j = 0; j < THREAD_ALLOCATION_COUNT; ++j) {
+            pe_free(blocks[i][j], THREAD_ALLOCATION_SIZE, MEMORY_TAG_JOB);
+        }
+    }
+
+    test_system_stop(&system);
+    return true;
+}
+
+typedef struct budget_listener {
+    u32 event_count;
+    u32 tag;
+    u64 allocated;
+} budget_listener;
+
+static b8 on_budget_exceeded(u16 code, void* sender, void* listener_inst, event_context context) {
+    budget_listener* listener = listener_inst;
+    listener->event_count++;
+    listener->tag = context.data.u32[0];
+    listener->allocated = context.data.u64[1];
+    return false;
+}
+
+u8 pe_memory_soft_limit_event_fires_once_per_crossing() {
+    memory_system_configuration config = {0};
+    config.budgets[MEMORY_TAG_TEXTURE].soft_limit = 1000;
+    memory_test_system system;
+    test_system_start(&system, config);
+
+    u64 event_memory_requirement = 0;
+    event_system_initialize(&event_memory_requirement, 0);
+    void* event_state = pe_allocate(event_memory_requirement, MEMORY_TAG_APPLICATION);
+    event_system_initialize(&event_memory_requirement, event_state);
+    budget_listener listener = {0};
+    event_register(EVENT_CODE_MEMORY_BUDGET_EXCEEDED, &listener, on_budget_exceeded);
+
+    void* a = pe_allocate(600, MEMORY_TAG_TEXTURE);
+    memory_system_update();
+    expect_should_be(0, listener.event_count);
+
+    // Crossing only flags the tag; the event waits for the update
+    void* b = pe_allocate(500, MEMORY_TAG_TEXTURE);
+    expect_should_be(0, listener.event_count);
+    // Already over, so no second crossing
+    void* c = pe_allocate(100, MEMORY_TAG_TEXTURE);
+    memory_system_update();
+    expect_should_be(1, listener.event_count);
+    expect_should_be(MEMORY_TAG_TEXTURE, listener.tag);
+    expect_should_be(1100, listener.allocated);
+
+    memory_system_update();
+    expect_should_be(1, listener.event_count);
+
+    // Dropping back under and crossing again is a new crossing
+    pe_free(b, 500, MEMORY_TAG_TEXTURE);
+    pe_free(c, 100, MEMORY_TAG_TEXTURE);
+    b = pe_allocate(700, MEMORY_TAG_TEXTURE);
+    memory_system_update();
+    expect_should_be(2, listener.event_count);
+    expect_should_be(1300, listener.allocated);
+
+    pe_free(a, 600, MEMORY_TAG_TEXTURE);
+    pe_free(b, 700, MEMORY_TAG_TEXTURE);
+
+    event_unregister(EVENT_CODE_MEMORY_BUDGET_EXCEEDED, &listener, on_budget_exceeded);
+    event_system_shutdown(event_state);
+    pe_free(event_state, event_memory_requirement, MEMORY_TAG_APPLICATION);
+    test_system_stop(&system);
+    return true;
+}
+
+void pe_memory_register_tests() {
+    test_manager_register_test(pe_memory_counts_runtime_heap_allocations, "Memory stats count runtime heap allocations");
+    test_manager_register_test(pe_memory_counts_engine_heap_allocations, "Memory stats count engine heap allocations");
+    test_manager_register_test(pe_memory_commit_counts_bytes_only, "Memory commit counts bytes only");
+    test_manager_register_test(pe_memory_rejects_unaligned_state, "Memory system rejects unaligned state");
+    test_manager_register_test(pe_memory_refuses_allocations_past_hard_limit, "Memory refuses allocations past hard limit");
+    test_manager_register_test(pe_memory_hard_limit_exact_across_threads, "Memory hard limit exact across threads");
+    test_manager_register_test(pe_memory_soft_limit_event_fires_once_per_crossing, "Memory soft limit event fires once per crossing");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void pe_memory_register_tests();
@@ -0,0 +1,134 @@
+#include "string_id_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/string_id.h>
+#include <core/pe_memory.h>
+#include <core/pe_string.h>
+#include <platform/platform.h>
+
+#define THREAD_COUNT 4
+#define THREADED_STRING_COUNT 2000
+
+typedef struct string_id_test_system {
+    u64 memory_requirement;
+    void* state;
+} string_id_test_system;
+
+static b8 test_system_start(string_id_test_system* system, u32 initial_capacity) {
+    string_id_system_initialize(&system->memory_requirement, 0, initial_capacity);
+    system->state = pe_allocate(system->memory_requirement, MEMORY_TAG_APPLICATION);
+    return string_id_system_initialize(&system->memory_requirement, system->state, initial_capacity);
+}
+
+static void test_system_stop(string_id_test_system* system) {
+    string_id_system_shutdown(system->state);
+    pe_free(system->state, system->memory_requirement, MEMORY_TAG_APPLICATION);
+}
+
+u8 string_id_intern_and_lookup() {
+    string_id_test_system system;
+    expect_to_be_true(test_system_start(&system, 0));
+
+    string_id diffuse = string_id_intern("diffuse_texture");
+    expect_should_not_be(STRING_ID_INVALID, diffuse);
+    // Interning again gives the same id and keeps the one copy
+    expect_should_be(diffuse, string_id_intern("diffuse_texture"));
+    const char* stored = string_id_lookup(diffuse);
+    expect_to_be_true(strings_equal("diffuse_texture", stored));
+    expect_should_be(stored, string_id_lookup(string_id_intern("diffuse_texture")));
+
+    string_id normal = string_id_intern("normal_texture");
+    expect_should_not_be(diffuse, normal);
+
+    expect_should_be(0, string_id_lookup(string_id_hash("never_interned")));
+    expect_should_be(0, string_id_lookup(STRING_ID_INVALID));
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 string_id_literal_and_runtime_ids_match() {
+    string_id_test_system system;
+    test_system_start(&system, 0);
+
+    // Every length bucket of the hash
+    const char* names[6] = {"", "ab", "mat_", "shader_builtin_a", "a_name_longer_than_sixteen_bytes",
+                            "a_name_that_runs_well_past_forty_eight_bytes_to_hit_the_bulk_loop"};
+    string_id literal_ids[6] = {STRING_ID(""), STRING_ID("ab"), STRING_ID("mat_"), STRING_ID("shader_builtin_a"),
+                                STRING_ID("a_name_longer_than_sixteen_bytes"),
+                                STRING_ID("a_name_that_runs_well_past_forty_eight_bytes_to_hit_the_bulk_loop")};
+    for (u32 i = 0; i < 6; ++i) {
+        expect_should_be(literal_ids[i], string_id_hash(names[i]));
+        expect_should_be(literal_ids[i], string_id_intern(names[i]));
+    }
+
+    // Differ by one byte
+    expect_should_not_be(STRING_ID("shader_builtin_a"), STRING_ID("shader_builtin_b"));
+
+    test_system_stop(&system);
+    return true;
+}
+
+u8 string_id_survives_table_growth() {
+    string_id_test_system system;
+    test_system_start(&system, 0);
+
+    char name[32];
+    string_id ids[3000];
+    for (u32 i = 0; i < 3000; ++i) {
+        string_format(name, "resource_%u", i);
+        ids[i] = string_id_intern(name);
+    }
+    for (u32 i = 0; i < 3000; ++i) {
+        string_format(name, "resource_%u", i);
+        expect_should_be(ids[i], string_id_hash(name));
+        expect_to_be_true(strings_equal(name, string_id_lookup(ids[i])));
+    }
+
+    test_system_stop(&system);
+    return true;
+}
+
+static u32 intern_worker(void* params) {
+    b8* ok = params;
+    char name[32];
+    // All threads intern the same names, racing to add each one first
+    for (u32 i = 0; i < THREADED_STRING_COUNT; ++i) {
+        string_format(name, "shared_%u", i);
+        string_id id = string_id_intern(name);
+        const char* stored = string_id_lookup(id);
+        if (!stored || !strings_equal(stored, name)) {
+            *ok = false;
+        }
+    }
+    return 0;
+}
+
+u8 string_id_intern_across_threads() {
+    string_id_test_system system;
+    test_system_start(&system, 0);
+
+    platform_thread threads[THREAD_COUNT];
+    b8 ok[THREAD_COUNT];
+    for (u32 i = 0; i < THREAD_COUNT; ++i) {
+        ok[i] = true;
+        expect_to_be_true(platform_thread_create(intern_worker, &ok[i], false, &threads[i]));
+    }
+    for (u32 i = 0; i < THREAD_COUNT; ++i) {
+        platform_thread_join(&threads[i]);
+        expect_to_be_true(ok[i]);
+    }
+
+    test_system_stop(&system);
+    return true;
+}
+
+void string_id_register_tests() {
+    test_manager_register_test(string_id_intern_and_lookup, "String ID intern and lookup");
+    test_manager_register_test(string_id_literal_and_runtime_ids_match, "String ID literal and runtime ids match");
+    test_manager_register_test(string_id_survives_table_growth, "String ID survives table growth");
+    test_manager_register_test(string_id_intern_across_threads, "String ID intern across threads");
+}
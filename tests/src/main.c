@@ -1,6 +1,20 @@
 #include "test_manager.h"
 
 #include "memory/linear_allocator_tests.h"
+#include "memory/dynamic_allocator_tests.h"
+#include "memory/pool_allocator_tests.h"
+#include "memory/frame_allocator_tests.h"
+#include "containers/darray_tests.h"
+#include "containers/hashtable_tests.h"
+#include "containers/ring_queue_tests.h"
+#include "containers/slot_map_tests.h"
+#include "containers/bitset_tests.h"
+#include "containers/sparse_set_tests.h"
+#include "core/pe_memory_tests.h"
+#include "core/string_id_tests.h"
+#include "core/frame_pacer_tests.h"
+#include "platform/filesystem_async_tests.h"
+#include "renderer/vulkan_host_allocator_tests.h"
 
 #include <core/logger.h>
 
@@ -10,6 +24,20 @@ int main() {
 
     // TODO: add test registrations here
     linear_allocator_register_tests();
+    dynamic_allocator_register_tests();
+    pool_allocator_register_tests();
+    frame_allocator_register_tests();
+    darray_register_tests();
+    hashtable_register_tests();
+    ring_queue_register_tests();
+    slot_map_register_tests();
+    bitset_register_tests();
+    sparse_set_register_tests();
+    pe_memory_register_tests();
+    string_id_register_tests();
+    frame_pacer_register_tests();
+    filesystem_async_register_tests();
+    vulkan_host_allocator_register_tests();
 
     PE_DEBUG("Starting tests...");
 
@@ -0,0 +1,188 @@
+#include "dynamic_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/pe_memory.h>
+#include <memory/dynamic_allocator.h>
+
+// Per-block bookkeeping; blocks are rounded up to 16 bytes with a 48 byte minimum
+#define BLOCK_OVERHEAD 16
+
+u8 dynamic_allocator_should_create_and_destroy() {
+    u64 total_size = 1024;
+    u64 memory_requirement = 0;
+    dynamic_allocator alloc;
+    expect_to_be_true(dynamic_allocator_create(total_size, &memory_requirement, 0, &alloc));
+    b8 includes_bookkeeping = memory_requirement > total_size;
+    expect_to_be_true(includes_bookkeeping);
+
+    void* memory = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(dynamic_allocator_create(total_size, &memory_requirement, memory, &alloc));
+    expect_should_not_be(0, alloc.memory);
+    expect_should_be(total_size, dynamic_allocator_free_space(&alloc));
+
+    dynamic_allocator_destroy(&alloc);
+    expect_should_be(0, alloc.memory);
+
+    pe_free(memory, memory_requirement, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 dynamic_allocator_single_allocation_and_free() {
+    u64 total_size = 1024;
+    u64 memory_requirement = 0;
+    dynamic_allocator alloc;
+    dynamic_allocator_create(total_size, &memory_requirement, 0, &alloc);
+    void* memory = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    dynamic_allocator_create(total_size, &memory_requirement, memory, &alloc);
+
+    void* block = dynamic_allocator_allocate(&alloc, 64);
+    expect_should_not_be(0, block);
+    expect_should_be(0, (u64)block % 16);
+    expect_to_be_true(dynamic_allocator_owns(&alloc, block));
+    expect_should_be(total_size - 64 - BLOCK_OVERHEAD, dynamic_allocator_free_space(&alloc));
+
+    expect_to_be_true(dynamic_allocator_free(&alloc, block));
+    expect_should_be(total_size, dynamic_allocator_free_space(&alloc));
+
+    dynamic_allocator_destroy(&alloc);
+    pe_free(memory, memory_requirement, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 dynamic_allocator_free_coalesces_neighbours() {
+    const u64 block_count = 32;
+    const u64 block_size = 48;
+    u64 total_size = block_count * (block_size + BLOCK_OVERHEAD);
+    u64 memory_requirement = 0;
+    dynamic_allocator alloc;
+    dynamic_allocator_create(total_size, &memory_requirement, 0, &alloc);
+    void* memory = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    dynamic_allocator_create(total_size, &memory_requirement, memory, &alloc);
+
+    // Fill the heap completely
+    void* blocks[32];
+    for (u64 i = 0; i < block_count; ++i) {
+        blocks[i] = dynamic_allocator_allocate(&alloc, block_size);
+        expect_should_not_be(0, blocks[i]);
+    }
+    expect_should_be(0, dynamic_allocator_free_space(&alloc));
+
+    // Free every other block, so no two free blocks touch
+    for (u64 i = 0; i < block_count; i += 2) {
+        expect_to_be_true(dynamic_allocator_free(&alloc, blocks[i]));
+    }
+
+    // Plenty of space in total, but none of it contiguous
+    expect_should_be(total_size / 2, dynamic_allocator_free_space(&alloc));
+    void* large = dynamic_allocator_allocate(&alloc, block_size * 2);
+    expect_should_be(0, large);
+
+    // Freeing the rest merges everything back into one block
+    for (u64 i = 1; i < block_count; i += 2) {
+        expect_to_be_true(dynamic_allocator_free(&alloc, blocks[i]));
+    }
+    expect_should_be(total_size, dynamic_allocator_free_space(&alloc));
+
+    large = dynamic_allocator_allocate(&alloc, total_size - BLOCK_OVERHEAD);
+    expect_should_not_be(0, large);
+    expect_should_be(0, dynamic_allocator_free_space(&alloc));
+    expect_to_be_true(dynamic_allocator_free(&alloc, large));
+
+    dynamic_allocator_destroy(&alloc);
+    pe_free(memory, memory_requirement, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 dynamic_allocator_over_allocate() {
+    u64 total_size = 1024;
+    u64 memory_requirement = 0;
+    dynamic_allocator alloc;
+    dynamic_allocator_create(total_size, &memory_requirement, 0, &alloc);
+    void* memory = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    dynamic_allocator_create(total_size, &memory_requirement, memory, &alloc);
+
+    // Verification: the block's overhead doesn't fit
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    void* block = dynamic_allocator_allocate(&alloc, total_size);
+    expect_should_be(0, block);
+    expect_should_be(total_size, dynamic_allocator_free_space(&alloc));
+
+    dynamic_allocator_destroy(&alloc);
+    pe_free(memory, memory_requirement, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 dynamic_allocator_aligned_allocation() {
+    u64 total_size = 8192;
+    u64 memory_requirement = 0;
+    dynamic_allocator alloc;
+    dynamic_allocator_create(total_size, &memory_requirement, 0, &alloc);
+    void* memory = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    dynamic_allocator_create(total_size, &memory_requirement, memory, &alloc);
+
+    void* blocks[5];
+    u16 alignments[5] = {8, 32, 64, 256, 1024};
+    for (u32 i = 0; i < 5; ++i) {
+        blocks[i] = dynamic_allocator_allocate_aligned(&alloc, 40, alignments[i]);
+        expect_should_not_be(0, blocks[i]);
+        expect_should_be(0, (u64)blocks[i] % alignments[i]);
+    }
+
+    for (u32 i = 0; i < 5; ++i) {
+        expect_to_be_true(dynamic_allocator_free(&alloc, blocks[i]));
+    }
+    expect_should_be(total_size, dynamic_allocator_free_space(&alloc));
+
+    dynamic_allocator_destroy(&alloc);
+    pe_free(memory, memory_requirement, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 dynamic_allocator_resize_in_place() {
+    u64 total_size = 1024;
+    u64 memory_requirement = 0;
+    dynamic_allocator alloc;
+    dynamic_allocator_create(total_size, &memory_requirement, 0, &alloc);
+    void* memory = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    dynamic_allocator_create(total_size, &memory_requirement, memory, &alloc);
+
+    u8* block = dynamic_allocator_allocate(&alloc, 64);
+    block[0] = 42;
+
+    // Everything behind the block is free, so it grows where it is
+    expect_to_be_true(dynamic_allocator_resize(&alloc, block, 512));
+    expect_should_be(total_size - 512 - BLOCK_OVERHEAD, dynamic_allocator_free_space(&alloc));
+    expect_should_be(42, block[0]);
+
+    // A neighbour in the way stops growth
+    void* blocker = dynamic_allocator_allocate(&alloc, 64);
+    expect_should_not_be(0, blocker);
+    expect_to_be_false(dynamic_allocator_resize(&alloc, block, 600));
+
+    // Shrinking hands the tail back, where the next allocation can use it
+    expect_to_be_true(dynamic_allocator_resize(&alloc, block, 64));
+    expect_should_be(total_size - 2 * (64 + BLOCK_OVERHEAD), dynamic_allocator_free_space(&alloc));
+    void* tail = dynamic_allocator_allocate(&alloc, 128);
+    expect_should_be(block + 64 + BLOCK_OVERHEAD, (u8*)tail);
+
+    expect_to_be_true(dynamic_allocator_free(&alloc, tail));
+    expect_to_be_true(dynamic_allocator_free(&alloc, blocker));
+    expect_to_be_true(dynamic_allocator_free(&alloc, block));
+    expect_should_be(total_size, dynamic_allocator_free_space(&alloc));
+
+    dynamic_allocator_destroy(&alloc);
+    pe_free(memory, memory_requirement, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+void dynamic_allocator_register_tests() {
+    test_manager_register_test(dynamic_allocator_should_create_and_destroy, "Dynamic allocator should create and destroy");
+    test_manager_register_test(dynamic_allocator_single_allocation_and_free, "Dynamic allocator single alloc and free");
+    test_manager_register_test(dynamic_allocator_free_coalesces_neighbours, "Dynamic allocator free coalesces neighbouring blocks");
+    test_manager_register_test(dynamic_allocator_over_allocate, "Dynamic allocator try over allocate");
+    test_manager_register_test(dynamic_allocator_aligned_allocation, "Dynamic allocator aligned alloc");
+    test_manager_register_test(dynamic_allocator_resize_in_place, "Dynamic allocator resize in place");
+}
@@ -0,0 +1,70 @@
+#include "frame_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/pe_memory.h>
+#include <memory/frame_allocator.h>
+
+u8 frame_allocator_keeps_memory_for_next_frame() {
+    u64 memory_requirement = 0;
+    frame_allocator_system_initialize(&memory_requirement, 0, 0, 0);
+    void* state = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(frame_allocator_system_initialize(&memory_requirement, state, 1024, 2));
+
+    frame_allocator_begin_frame();
+    u64* first = frame_allocate(sizeof(u64));
+    expect_should_not_be(0, first);
+    expect_should_be(0, (u64)first % 16);
+    expect_should_be(0, *first);
+    *first = 42;
+
+    // Still intact during the next frame, which uses the other buffer
+    frame_allocator_begin_frame();
+    u64* second = frame_allocate(sizeof(u64));
+    expect_should_not_be(first, second);
+    expect_should_be(42, *first);
+
+    // The first buffer comes around again, cleared
+    frame_allocator_begin_frame();
+    u64* third = frame_allocate(sizeof(u64));
+    expect_should_be(first, third);
+    expect_should_be(0, *third);
+
+    frame_allocator_system_shutdown(state);
+    pe_free(state, memory_requirement, MEMORY_TAG_APPLICATION);
+
+    return true;
+}
+
+u8 frame_allocator_fails_when_frame_buffer_full() {
+    u64 memory_requirement = 0;
+    frame_allocator_system_initialize(&memory_requirement, 0, 0, 0);
+    void* state = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    frame_allocator_system_initialize(&memory_requirement, state, 256, 3);
+
+    frame_allocator_begin_frame();
+    expect_should_not_be(0, frame_allocate(200));
+    void* aligned = frame_allocate_aligned(32, 32);
+    expect_should_not_be(0, aligned);
+    expect_should_be(0, (u64)aligned % 32);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, frame_allocate(64));
+
+    // Plenty of room again once the frame moves on
+    frame_allocator_begin_frame();
+    expect_should_not_be(0, frame_allocate(256));
+    expect_should_be(256, frame_allocator_peak_usage());
+
+    frame_allocator_system_shutdown(state);
+    pe_free(state, memory_requirement, MEMORY_TAG_APPLICATION);
+
+    return true;
+}
+
+void frame_allocator_register_tests() {
+    test_manager_register_test(frame_allocator_keeps_memory_for_next_frame, "Frame allocator keeps memory for the next frame");
+    test_manager_register_test(frame_allocator_fails_when_frame_buffer_full, "Frame allocator fails when the frame buffer is full");
+}
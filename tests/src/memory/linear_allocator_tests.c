@@ -4,6 +4,7 @@
 
 #include <defines.h>
 
+#include <core/pe_memory.h>
 #include <memory/linear_allocator.h>
 
 u8 linear_allocator_should_create_and_destroy() {
@@ -100,7 +101,7 @@ u8 linear_allocator_multi_allocation_all_space_then_free() {
     }
 
     // Validate that pointer is reset
-    linear_allocator_free_all(&alloc);
+    linear_allocator_free_all(&alloc, false);
     expect_should_be(0, alloc.allocated);
 
     linear_allocator_destroy(&alloc);
@@ -108,10 +109,141 @@ u8 linear_allocator_multi_allocation_all_space_then_free() {
     return true;
 }
 
+u8 linear_allocator_aligned_allocation_pads_to_alignment() {
+    linear_allocator alloc;
+    linear_allocator_create(1024, 0, &alloc);
+
+    // Knock the offset off any alignment
+    void* block = linear_allocator_allocate(&alloc, 1);
+    expect_should_not_be(0, block);
+
+    block = linear_allocator_allocate_aligned(&alloc, 64, 256);
+    expect_should_not_be(0, block);
+    expect_should_be(0, ((u64)block % 256));
+
+    // Padding is recorded and counted as allocated
+    u64 padding = (u64)block - ((u64)alloc.memory + 1);
+    expect_should_be(padding, alloc.alignment_padding);
+    expect_should_be(1 + padding + 64, alloc.allocated);
+
+    linear_allocator_free_all(&alloc, false);
+    expect_should_be(0, alloc.alignment_padding);
+
+    linear_allocator_destroy(&alloc);
+
+    return true;
+}
+
+u8 linear_allocator_aligned_allocation_over_allocate() {
+    linear_allocator alloc;
+    linear_allocator_create(64, 0, &alloc);
+
+    void* block = linear_allocator_allocate(&alloc, 60);
+    expect_should_not_be(0, block);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+
+    // Fits without padding, but not once aligned
+    block = linear_allocator_allocate_aligned(&alloc, 4, 16);
+    expect_should_be(0, block);
+    expect_should_be(60, alloc.allocated);
+    expect_should_be(0, alloc.alignment_padding);
+
+    linear_allocator_destroy(&alloc);
+
+    return true;
+}
+
+u8 linear_allocator_free_all_clears_used_bytes() {
+    linear_allocator alloc;
+    linear_allocator_create(64, 0, &alloc);
+
+    u8* block = linear_allocator_allocate(&alloc, 16);
+    pe_set_memory(block, 0xAB, 16);
+
+    linear_allocator_free_all(&alloc, true);
+    expect_should_be(0, alloc.allocated);
+    block = linear_allocator_allocate(&alloc, 16);
+    for (u32 i = 0; i < 16; ++i) {
+        expect_should_be(0, block[i]);
+    }
+
+    linear_allocator_destroy(&alloc);
+
+    return true;
+}
+
+u8 linear_allocator_free_to_marker_rolls_back() {
+    linear_allocator alloc;
+    linear_allocator_create(256, 0, &alloc);
+
+    void* outer = linear_allocator_allocate(&alloc, 8);
+    linear_allocator_marker marker = linear_allocator_get_marker(&alloc);
+    expect_should_be(8, marker.allocated);
+
+    // Scoped allocations after the marker
+    void* inner = linear_allocator_allocate_aligned(&alloc, 32, 64);
+    expect_should_not_be(0, inner);
+    u8* bytes = linear_allocator_allocate(&alloc, 16);
+    pe_set_memory(bytes, 0xAB, 16);
+    expect_should_not_be(0, alloc.alignment_padding);
+
+    linear_allocator_free_to_marker(&alloc, marker, true);
+    expect_should_be(8, alloc.allocated);
+    expect_should_be(0, alloc.alignment_padding);
+    for (u32 i = 0; i < 16; ++i) {
+        expect_should_be(0, bytes[i]);
+    }
+
+    // Allocations before the marker are untouched, and space is reused from the marker on
+    expect_should_be((u8*)outer + 8, linear_allocator_allocate(&alloc, 8));
+
+    linear_allocator_destroy(&alloc);
+
+    return true;
+}
+
+u8 linear_allocator_virtual_commits_on_demand() {
+    linear_allocator alloc;
+    u64 reserve_size = 64 * 1024 * 1024;
+    expect_to_be_true(linear_allocator_create_virtual(reserve_size, false, &alloc));
+    expect_should_be(reserve_size, alloc.total_size);
+    expect_should_be(0, alloc.committed);
+
+    u64 page_size = pe_memory_page_size();
+    u8* block = linear_allocator_allocate(&alloc, 16);
+    expect_should_not_be(0, block);
+    expect_should_be(page_size, alloc.committed);
+    // Committed memory starts out zeroed and is writable
+    expect_should_be(0, block[15]);
+    block[15] = 1;
+
+    // Crossing into the next page commits it
+    u8* large = linear_allocator_allocate(&alloc, page_size);
+    expect_should_not_be(0, large);
+    expect_should_be(page_size * 2, alloc.committed);
+    large[page_size - 1] = 1;
+
+    // Rolling back keeps the memory committed
+    linear_allocator_free_all(&alloc, false);
+    expect_should_be(page_size * 2, alloc.committed);
+
+    linear_allocator_destroy(&alloc);
+    expect_should_be(0, alloc.memory);
+    expect_should_be(0, alloc.committed);
+
+    return true;
+}
+
 void linear_allocator_register_tests() {
     test_manager_register_test(linear_allocator_should_create_and_destroy, "linear allocator should create and destroy");
     test_manager_register_test(linear_allocator_single_allocation_all_space, "Linear allocator single alloc for all space");
     test_manager_register_test(linear_allocator_multi_allocation_all_space, "Linear allocator multi alloc for all space");
     test_manager_register_test(linear_allocator_multi_allocation_over_allocate, "Linear allocator try over allocate");
     test_manager_register_test(linear_allocator_multi_allocation_all_space_then_free, "Linear allocator allocated should be 0 after free_all");
+    test_manager_register_test(linear_allocator_aligned_allocation_pads_to_alignment, "Linear allocator aligned alloc pads to alignment");
+    test_manager_register_test(linear_allocator_aligned_allocation_over_allocate, "Linear allocator aligned alloc fails when padding does not fit");
+    test_manager_register_test(linear_allocator_free_all_clears_used_bytes, "Linear allocator free_all clears used bytes when asked");
+    test_manager_register_test(linear_allocator_free_to_marker_rolls_back, "Linear allocator free_to_marker rolls back");
+    test_manager_register_test(linear_allocator_virtual_commits_on_demand, "Virtual linear allocator commits on demand");
 }
\ No newline at end of file
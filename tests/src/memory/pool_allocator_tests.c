@@ -0,0 +1,114 @@
+#include "pool_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <memory/pool_allocator.h>
+
+typedef struct test_object {
+    u64 id;
+    f32 position[3];
+} test_object;
+
+u8 pool_allocator_should_create_and_destroy() {
+    pool_allocator pool;
+    expect_to_be_true(pool_allocator_create("test", sizeof(test_object), 64, false, MEMORY_TAG_ENTITY, &pool));
+
+    expect_should_not_be(0, pool.chunks);
+    expect_should_be(1, pool.chunk_count);
+    expect_should_be(0, pool.live_count);
+    // Rounded up to fill whole pages
+    b8 has_requested_capacity = pool.capacity >= 64;
+    expect_to_be_true(has_requested_capacity);
+
+    pool_allocator_destroy(&pool);
+    expect_should_be(0, pool.chunks);
+    expect_should_be(0, pool.capacity);
+
+    return true;
+}
+
+u8 pool_allocator_free_reuses_blocks() {
+    pool_allocator pool;
+    pool_allocator_create("test", sizeof(test_object), 64, false, MEMORY_TAG_ENTITY, &pool);
+
+    test_object* a = pool_allocator_allocate(&pool);
+    test_object* b = pool_allocator_allocate(&pool);
+    expect_should_not_be(0, a);
+    expect_should_not_be(0, b);
+    expect_should_not_be(a, b);
+    expect_should_be(0, (u64)a % 16);
+    expect_should_be(2, pool.live_count);
+
+    // Most recently freed block comes back first
+    pool_allocator_free(&pool, a);
+    pool_allocator_free(&pool, b);
+    expect_should_be(0, pool.live_count);
+    expect_should_be(b, pool_allocator_allocate(&pool));
+    expect_should_be(a, pool_allocator_allocate(&pool));
+    expect_should_be(2, pool.peak_count);
+
+    pool_allocator_free(&pool, a);
+    pool_allocator_free(&pool, b);
+    pool_allocator_destroy(&pool);
+
+    return true;
+}
+
+u8 pool_allocator_fixed_pool_fails_when_full() {
+    pool_allocator pool;
+    pool_allocator_create("test", sizeof(test_object), 1, false, MEMORY_TAG_ENTITY, &pool);
+
+    u64 capacity = pool.capacity;
+    for (u64 i = 0; i < capacity; ++i) {
+        test_object* object = pool_allocator_allocate(&pool);
+        expect_should_not_be(0, object);
+        object->id = i;
+    }
+    expect_should_be(capacity, pool.live_count);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, pool_allocator_allocate(&pool));
+    expect_should_be(1, pool.chunk_count);
+
+    pool_allocator_destroy(&pool);
+
+    return true;
+}
+
+u8 pool_allocator_growable_pool_adds_chunks() {
+    pool_allocator pool;
+    pool_allocator_create("test", sizeof(test_object), 1, true, MEMORY_TAG_ENTITY, &pool);
+
+    u64 first_capacity = pool.capacity;
+    test_object* first = 0;
+    test_object* last = 0;
+    for (u64 i = 0; i < first_capacity + 1; ++i) {
+        last = pool_allocator_allocate(&pool);
+        expect_should_not_be(0, last);
+        last->id = i;
+        if (i == 0) {
+            first = last;
+        }
+    }
+    expect_should_be(2, pool.chunk_count);
+    expect_should_be(first_capacity * 2, pool.capacity);
+    expect_to_be_true(pool_allocator_owns(&pool, first));
+    expect_to_be_true(pool_allocator_owns(&pool, last));
+    expect_should_be(0, first->id);
+
+    // Not on a block boundary
+    expect_to_be_false(pool_allocator_owns(&pool, (u8*)first + 1));
+
+    pool_allocator_destroy(&pool);
+
+    return true;
+}
+
+void pool_allocator_register_tests() {
+    test_manager_register_test(pool_allocator_should_create_and_destroy, "Pool allocator should create and destroy");
+    test_manager_register_test(pool_allocator_free_reuses_blocks, "Pool allocator free reuses blocks");
+    test_manager_register_test(pool_allocator_fixed_pool_fails_when_full, "Pool allocator fixed pool fails when full");
+    test_manager_register_test(pool_allocator_growable_pool_adds_chunks, "Pool allocator growable pool adds chunks");
+}
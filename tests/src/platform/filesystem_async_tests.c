@@ -0,0 +1,112 @@
+#include "filesystem_async_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/pe_memory.h>
+#include <platform/filesystem.h>
+
+// For removing the test file
+#include <stdio.h>
+
+#define TEST_FILE_PATH "filesystem_async_test.bin"
+#define TEST_FILE_SIZE 1000
+
+typedef struct read_completion {
+    u32 callback_count;
+    u32 status;
+    u64 bytes_transferred;
+} read_completion;
+
+static void on_read_complete(file_io_request* request) {
+    read_completion* completion = request->user_data;
+    completion->callback_count++;
+    completion->status = request->status;
+    completion->bytes_transferred = request->bytes_transferred;
+}
+
+static b8 write_test_file() {
+    u8 data[TEST_FILE_SIZE];
+    for (u32 i = 0; i < TEST_FILE_SIZE; ++i) {
+        data[i] = (u8)(i * 7);
+    }
+
+    file_handle handle;
+    if (!filesystem_open(TEST_FILE_PATH, FILE_MODE_WRITE, true, &handle)) {
+        return false;
+    }
+    u64 written = 0;
+    b8 result = filesystem_write(&handle, TEST_FILE_SIZE, data, &written) && written == TEST_FILE_SIZE;
+    filesystem_close(&handle);
+    return result;
+}
+
+u8 filesystem_async_read_completes_on_worker_threads() {
+    expect_to_be_true(write_test_file());
+
+    // Queue depth 0 forces the thread pool, even where io_uring is available
+    u64 memory_requirement = 0;
+    filesystem_async_system_initialize(&memory_requirement, 0, 0, 2);
+    void* state = pe_allocate(memory_requirement, MEMORY_TAG_APPLICATION);
+    expect_to_be_true(filesystem_async_system_initialize(&memory_requirement, state, 0, 2));
+
+    file_handle handle;
+    expect_to_be_true(filesystem_open(TEST_FILE_PATH, FILE_MODE_READ, true, &handle));
+
+    // One read in the middle, one running past the end of the file
+    u8 middle[100];
+    read_completion middle_completion = {0};
+    file_io_request middle_request = {0};
+    middle_request.handle = &handle;
+    middle_request.offset = 500;
+    middle_request.size = sizeof(middle);
+    middle_request.buffer = middle;
+    middle_request.callback = on_read_complete;
+    middle_request.user_data = &middle_completion;
+
+    u8 tail[64];
+    read_completion tail_completion = {0};
+    file_io_request tail_request = middle_request;
+    tail_request.offset = TEST_FILE_SIZE - 16;
+    tail_request.size = sizeof(tail);
+    tail_request.buffer = tail;
+    tail_request.user_data = &tail_completion;
+
+    expect_to_be_true(filesystem_read_async(&middle_request));
+    expect_to_be_true(filesystem_read_async(&tail_request));
+
+    expect_to_be_true(filesystem_async_wait(&middle_request));
+    expect_to_be_true(filesystem_async_wait(&tail_request));
+    expect_to_be_true(filesystem_async_poll(&middle_request));
+
+    // Callbacks only run from filesystem_async_update, on this thread
+    expect_should_be(0, middle_completion.callback_count);
+    filesystem_async_update();
+    expect_should_be(1, middle_completion.callback_count);
+    expect_should_be(1, tail_completion.callback_count);
+    expect_should_be(FILE_IO_STATUS_COMPLETE, middle_completion.status);
+    expect_should_be(FILE_IO_STATUS_COMPLETE, tail_completion.status);
+
+    expect_should_be(sizeof(middle), middle_completion.bytes_transferred);
+    for (u32 i = 0; i < sizeof(middle); ++i) {
+        expect_should_be((u8)((500 + i) * 7), middle[i]);
+    }
+    expect_should_be(16, tail_completion.bytes_transferred);
+    expect_should_be((u8)((TEST_FILE_SIZE - 1) * 7), tail[15]);
+
+    // Nothing runs twice
+    filesystem_async_update();
+    expect_should_be(1, middle_completion.callback_count);
+
+    filesystem_close(&handle);
+    filesystem_async_system_shutdown(state);
+    pe_free(state, memory_requirement, MEMORY_TAG_APPLICATION);
+    remove(TEST_FILE_PATH);
+
+    return true;
+}
+
+void filesystem_async_register_tests() {
+    test_manager_register_test(filesystem_async_read_completes_on_worker_threads, "Async read completes on worker threads");
+}
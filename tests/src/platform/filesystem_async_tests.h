@@ -0,0 +1,3 @@
+#pragma once
+
+void filesystem_async_register_tests();
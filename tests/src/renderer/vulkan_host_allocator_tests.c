@@ -0,0 +1,182 @@
+#include "vulkan_host_allocator_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/pe_memory.h>
+#include <renderer/vulkan/vulkan_host_allocator.h>
+
+#define SCOPE_COUNT 5
+
+typedef struct host_allocator_test {
+    u64 memory_requirement;
+    void* memory_state;
+    vulkan_host_allocator allocator;
+} host_allocator_test;
+
+// The memory system is started so the per-tag stats show what the callbacks account
+static b8 test_start(host_allocator_test* test) {
+    memory_system_configuration config = {0};
+    memory_system_initialize(&test->memory_requirement, 0, config);
+    test->memory_state = pe_allocate_aligned(test->memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+    return memory_system_initialize(&test->memory_requirement, test->memory_state, config) &&
+           vulkan_host_allocator_create(&test->allocator);
+}
+
+static void test_stop(host_allocator_test* test) {
+    vulkan_host_allocator_destroy(&test->allocator);
+    memory_system_shutdown(test->memory_state);
+    pe_free_aligned(test->memory_state, test->memory_requirement, PE_CACHE_LINE_SIZE, MEMORY_TAG_APPLICATION);
+}
+
+static void* host_allocate(host_allocator_test* test, u64 size, u64 alignment, VkSystemAllocationScope scope) {
+    const VkAllocationCallbacks* callbacks = &test->allocator.callbacks;
+    return callbacks->pfnAllocation(callbacks->pUserData, size, alignment, scope);
+}
+
+static void* host_reallocate(host_allocator_test* test, void* original, u64 size, u64 alignment, VkSystemAllocationScope scope) {
+    const VkAllocationCallbacks* callbacks = &test->allocator.callbacks;
+    return callbacks->pfnReallocation(callbacks->pUserData, original, size, alignment, scope);
+}
+
+static void host_free(host_allocator_test* test, void* memory) {
+    const VkAllocationCallbacks* callbacks = &test->allocator.callbacks;
+    callbacks->pfnFree(callbacks->pUserData, memory);
+}
+
+// Checks the tag's live bytes and allocations, e.g. that blocks were freed with the size they were accounted with
+static b8 tag_live_is(memory_tag tag, u64 expected_bytes, u64 expected_live_count) {
+    memory_tag_stats stats;
+    memory_get_tag_stats(tag, &stats);
+    return stats.allocated_bytes == expected_bytes && stats.allocation_count - stats.free_count == expected_live_count;
+}
+
+u8 vulkan_host_allocator_honours_size_and_alignment() {
+    host_allocator_test test;
+    expect_to_be_true(test_start(&test));
+
+    const VkSystemAllocationScope scopes[SCOPE_COUNT - 1] = {
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, VK_SYSTEM_ALLOCATION_SCOPE_CACHE,
+        VK_SYSTEM_ALLOCATION_SCOPE_DEVICE, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE};
+    const memory_tag tags[SCOPE_COUNT - 1] = {
+        MEMORY_TAG_VULKAN_OBJECT, MEMORY_TAG_VULKAN_CACHE, MEMORY_TAG_VULKAN_DEVICE, MEMORY_TAG_VULKAN_INSTANCE};
+    const u64 alignments[6] = {1, 8, 16, 64, 256, 4096};
+    const u64 sizes[3] = {1, 24, 1000};
+
+    u8* blocks[SCOPE_COUNT - 1][6][3];
+    for (u32 s = 0; s < SCOPE_COUNT - 1; ++s) {
+        for (u32 a = 0; a < 6; ++a) {
+            for (u32 z = 0; z < 3; ++z) {
+                u8* block = host_allocate(&test, sizes[z], alignments[a], scopes[s]);
+                expect_should_not_be(0, block);
+                expect_should_be(0, (u64)block % alignments[a]);
+                // The whole requested size is usable without touching the bookkeeping
+                pe_set_memory(block, 0xAB, sizes[z]);
+                blocks[s][a][z] = block;
+            }
+        }
+
+        memory_tag_stats stats;
+        memory_get_tag_stats(tags[s], &stats);
+        expect_should_be(6 * 3, stats.allocation_count);
+    }
+
+    for (u32 s = 0; s < SCOPE_COUNT - 1; ++s) {
+        for (u32 a = 0; a < 6; ++a) {
+            for (u32 z = 0; z < 3; ++z) {
+                expect_should_be(0xAB, blocks[s][a][z][sizes[z] - 1]);
+                host_free(&test, blocks[s][a][z]);
+            }
+        }
+        expect_to_be_true(tag_live_is(tags[s], 0, 0));
+    }
+
+    // Freeing null is allowed
+    host_free(&test, 0);
+
+    PE_DEBUG("Note: The following error is intentionally caused by this test.");
+    expect_should_be(0, host_allocate(&test, 16, 65536, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+
+    test_stop(&test);
+    return true;
+}
+
+u8 vulkan_host_allocator_reallocate_keeps_contents() {
+    host_allocator_test test;
+    test_start(&test);
+
+    u8* block = host_reallocate(&test, 0, 100, 16, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    expect_should_not_be(0, block);
+    for (u32 i = 0; i < 100; ++i) {
+        block[i] = (u8)i;
+    }
+
+    // Grows to a stricter alignment
+    block = host_reallocate(&test, block, 5000, 256, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    expect_should_not_be(0, block);
+    expect_should_be(0, (u64)block % 256);
+    for (u32 i = 0; i < 100; ++i) {
+        expect_should_be((u8)i, block[i]);
+    }
+
+    block = host_reallocate(&test, block, 10, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    expect_should_not_be(0, block);
+    for (u32 i = 0; i < 10; ++i) {
+        expect_should_be((u8)i, block[i]);
+    }
+
+    // Size 0 frees
+    expect_should_be(0, host_reallocate(&test, block, 0, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+    expect_to_be_true(tag_live_is(MEMORY_TAG_VULKAN_OBJECT, 0, 0));
+
+    test_stop(&test);
+    return true;
+}
+
+u8 vulkan_host_allocator_command_scope_uses_arena() {
+    host_allocator_test test;
+    test_start(&test);
+
+    // Only the arena itself is accounted under the command tag
+    memory_tag_stats arena_stats;
+    memory_get_tag_stats(MEMORY_TAG_VULKAN_COMMAND, &arena_stats);
+
+    linear_allocator* arena = &test.allocator.command_arena;
+    u8* arena_start = arena->memory;
+    u8* arena_end = arena_start + arena->total_size;
+
+    u8* first = host_allocate(&test, 100, 16, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    u8* second = host_allocate(&test, 300, 64, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    b8 in_arena = first >= arena_start && first + 100 <= arena_end && second >= arena_start && second + 300 <= arena_end;
+    expect_to_be_true(in_arena);
+    expect_should_be(0, (u64)second % 64);
+    expect_should_be(2, test.allocator.command_arena_live_count);
+    expect_to_be_true(tag_live_is(MEMORY_TAG_VULKAN_COMMAND, arena_stats.allocated_bytes, 1));
+
+    // Too big for the arena, so it comes from the heap instead
+    u8* overflow = host_allocate(&test, arena->total_size, 16, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    expect_should_not_be(0, overflow);
+    b8 outside_arena = overflow + arena->total_size <= arena_start || overflow >= arena_end;
+    expect_to_be_true(outside_arena);
+    expect_should_be(1, test.allocator.command_arena_overflow_count);
+    host_free(&test, overflow);
+    expect_to_be_true(tag_live_is(MEMORY_TAG_VULKAN_COMMAND, arena_stats.allocated_bytes, 1));
+
+    // The arena only rewinds once the last of its blocks is freed
+    host_free(&test, first);
+    b8 still_in_use = arena->allocated > 0;
+    expect_to_be_true(still_in_use);
+    host_free(&test, second);
+    expect_should_be(0, arena->allocated);
+    expect_should_be(0, test.allocator.command_arena_live_count);
+
+    test_stop(&test);
+    return true;
+}
+
+void vulkan_host_allocator_register_tests() {
+    test_manager_register_test(vulkan_host_allocator_honours_size_and_alignment, "Vulkan host allocator honours size and alignment");
+    test_manager_register_test(vulkan_host_allocator_reallocate_keeps_contents, "Vulkan host allocator reallocate keeps contents");
+    test_manager_register_test(vulkan_host_allocator_command_scope_uses_arena, "Vulkan host allocator command scope uses arena");
+}
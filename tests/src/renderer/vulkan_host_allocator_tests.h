@@ -0,0 +1,3 @@
+#pragma once
+
+void vulkan_host_allocator_register_tests();